@@ -0,0 +1,138 @@
+#include "BlockReader.hpp"
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+BlockReader::BlockReader()
+	: fd_(-1), owned_(false), begin_(0), end_(0), eof_(true), failed_(false), ranged_(false), offset_(0),
+	left_(0) {}
+
+// Orthodox Canonical Form - a reader may own its descriptor, so it isn't copied
+BlockReader::BlockReader(const BlockReader& other)
+	: fd_(-1), owned_(false), begin_(0), end_(0), eof_(true), failed_(other.failed_), ranged_(false),
+	offset_(0), left_(0) {}
+BlockReader& BlockReader::operator=(const BlockReader& other) { (void)other; return *this; }
+
+BlockReader::~BlockReader()
+{
+	close();
+}
+
+bool BlockReader::open(const std::string& path, size_t blockBytes)
+{
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	attach(fd, blockBytes);
+	owned_ = true;
+	return true;
+}
+
+void BlockReader::attach(int fd, size_t blockBytes)
+{
+	close();
+	fd_ = fd;
+	buffer_.resize(blockBytes > 0 ? blockBytes : 1);
+	eof_ = false;
+}
+
+void BlockReader::attachRange(int fd, off_t offset, size_t length, size_t blockBytes)
+{
+	attach(fd, blockBytes);
+	ranged_ = true;
+	offset_ = offset;
+	left_ = length;
+	eof_ = (length == 0);
+}
+
+void BlockReader::close()
+{
+	if (owned_ && fd_ >= 0)
+		::close(fd_);
+	fd_ = -1;
+	owned_ = false;
+	begin_ = 0;
+	end_ = 0;
+	eof_ = true;
+	failed_ = false;
+	ranged_ = false;
+	offset_ = 0;
+	left_ = 0;
+}
+
+int BlockReader::fd() const
+{
+	return fd_;
+}
+
+const char* BlockReader::data() const
+{
+	return buffer_.empty() ? NULL : &buffer_[0];
+}
+
+size_t BlockReader::begin() const
+{
+	return begin_;
+}
+
+size_t BlockReader::end() const
+{
+	return end_;
+}
+
+void BlockReader::consume(size_t count)
+{
+	begin_ += count;
+}
+
+bool BlockReader::full() const
+{
+	return begin_ == 0 && end_ == buffer_.size();
+}
+
+void BlockReader::refill()
+{
+	if (eof_)
+		return;
+	std::memmove(&buffer_[0], &buffer_[begin_], end_ - begin_);
+	end_ -= begin_;
+	begin_ = 0;
+	if (end_ == buffer_.size())
+		buffer_.resize(buffer_.size() * 2);
+
+	size_t room = buffer_.size() - end_;
+	if (ranged_ && room > left_)
+		room = left_;
+
+	ssize_t got;
+	do
+		got = ranged_ ? ::pread(fd_, &buffer_[end_], room, offset_) : ::read(fd_, &buffer_[end_], room);
+	while (got < 0 && errno == EINTR);
+
+	if (got < 0)
+		failed_ = true;
+	if (got <= 0)
+		eof_ = true;
+	else
+	{
+		end_ += got;
+		if (ranged_)
+		{
+			offset_ += got;
+			left_ -= got;
+			eof_ = (left_ == 0);
+		}
+	}
+}
+
+bool BlockReader::eof() const
+{
+	return eof_;
+}
+
+bool BlockReader::failed() const
+{
+	return failed_;
+}
@@ -0,0 +1,71 @@
+#ifndef BLOCKREADER_HPP
+# define BLOCKREADER_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <sys/types.h>
+
+// The one read(2) loop behind every streamed input: btc's LineReader,
+// PmergeMe's NumberReader and the external sort's run readers. Bytes are
+// read in large blocks into one buffer; callers parse them in place
+// between begin() and end() and consume() what they are done with.
+// refill() keeps the unconsumed tail and reads behind it.
+class BlockReader
+{
+public:
+	static const size_t defaultBlockSize = 1 << 20;
+
+private:
+	int					fd_;
+	bool				owned_;		// fd_ was opened here and is closed here
+	std::vector<char>	buffer_;
+	size_t				begin_;		// first byte not consumed yet
+	size_t				end_;		// end of the bytes read so far
+	bool				eof_;
+	bool				failed_;
+	bool				ranged_;	// reads one extent with pread(2)
+	off_t				offset_;	// next file offset to read, when ranged
+	size_t				left_;		// bytes of the extent not read yet
+
+	BlockReader(const BlockReader& other);
+	BlockReader& operator=(const BlockReader& other);
+
+public:
+	BlockReader();
+	~BlockReader();	// closes the descriptor if open() opened it
+
+	// Reads the named file; fails if it can't be opened
+	bool open(const std::string& path, size_t blockBytes = defaultBlockSize);
+
+	// Reads a descriptor opened elsewhere (stdin, a temporary file), which
+	// stays open afterwards
+	void attach(int fd, size_t blockBytes = defaultBlockSize);
+
+	// Reads the `length` bytes at `offset` of a descriptor opened elsewhere,
+	// then reports eof(). The descriptor's own file position isn't used, so
+	// any number of readers may share one descriptor.
+	void attachRange(int fd, off_t offset, size_t length, size_t blockBytes = defaultBlockSize);
+
+	// Back to the state of a new reader: nothing to read
+	void close();
+
+	int fd() const;
+	const char* data() const;
+	size_t begin() const;
+	size_t end() const;
+	void consume(size_t count);
+
+	// The unconsumed bytes fill the whole buffer
+	bool full() const;
+
+	// Moves the unconsumed bytes to the front, doubling the buffer if they
+	// already fill it, and reads once behind them. Sets eof() at the end
+	// of the input, and failed() as well on a read error.
+	void refill();
+
+	bool eof() const;
+	bool failed() const;
+};
+
+#endif
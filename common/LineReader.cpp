@@ -0,0 +1,109 @@
+#include "LineReader.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+LineReader::LineReader() : fd_(-1), map_(NULL), mapLength_(0), mapBegin_(0) {}
+
+// Orthodox Canonical Form - a reader owns its descriptor, so it isn't copied
+LineReader::LineReader(const LineReader& other) : fd_(-1), map_(NULL), mapLength_(0), mapBegin_(0)
+{
+	(void)other;
+}
+LineReader& LineReader::operator=(const LineReader& other) { (void)other; return *this; }
+
+LineReader::~LineReader()
+{
+	release();
+}
+
+void LineReader::release()
+{
+	block_.close();
+	if (map_)
+		munmap(map_, mapLength_);
+	if (fd_ >= 0)
+		close(fd_);
+	fd_ = -1;
+	map_ = NULL;
+	mapLength_ = 0;
+	mapBegin_ = 0;
+}
+
+bool LineReader::open(const std::string& path, Mode mode)
+{
+	release();
+	fd_ = ::open(path.c_str(), O_RDONLY);
+	if (fd_ < 0)
+		return false;
+
+	if (mode == Mapped && map())
+		return true;
+	block_.attach(fd_);
+	return true;
+}
+
+// Regular, non-empty files only; anything else is read in blocks
+bool LineReader::map()
+{
+	struct stat info;
+	if (fstat(fd_, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+		return false;
+
+	void* address = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+	if (address == MAP_FAILED)
+		return false;
+	madvise(address, info.st_size, MADV_SEQUENTIAL);
+
+	map_ = static_cast<char*>(address);
+	mapLength_ = info.st_size;
+	return true;
+}
+
+bool LineReader::next(const char*& line, size_t& length)
+{
+	if (map_)
+	{
+		if (mapBegin_ == mapLength_)
+			return false;
+		const char* start = map_ + mapBegin_;
+		const char* newline = static_cast<const char*>(std::memchr(start, '\n', mapLength_ - mapBegin_));
+		line = start;
+		length = newline ? static_cast<size_t>(newline - start) : mapLength_ - mapBegin_;
+		mapBegin_ += newline ? length + 1 : length;
+		return true;
+	}
+
+	while (true)
+	{
+		const char* start = block_.data() + block_.begin();
+		size_t available = block_.end() - block_.begin();
+		const char* newline = available ? static_cast<const char*>(std::memchr(start, '\n', available)) : NULL;
+
+		if (newline)
+		{
+			line = start;
+			length = newline - start;
+			block_.consume(length + 1);
+			return true;
+		}
+		if (block_.eof())
+		{
+			if (available == 0)
+				return false;
+			line = start;
+			length = available;
+			block_.consume(available);
+			return true;
+		}
+		// An unfinished line that fills the buffer makes refill() grow it
+		block_.refill();
+	}
+}
+
+bool LineReader::failed() const
+{
+	return block_.failed();
+}
@@ -0,0 +1,50 @@
+#ifndef LINEREADER_HPP
+# define LINEREADER_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "BlockReader.hpp"
+
+// Line-by-line input without a std::string per line. The file is read
+// in large blocks by a BlockReader and split in place, or mapped whole with
+// mmap(2) when asked to and possible; either way next() hands out a
+// pointer into that storage. Lines are exactly what std::getline would
+// return: the '\n' is dropped, a '\r' is kept, and a last line without
+// a newline still counts.
+class LineReader
+{
+public:
+	enum Mode
+	{
+		Buffered,	// read(2) into a growing block buffer
+		Mapped		// mmap(2) for regular files, Buffered otherwise
+	};
+
+private:
+	int					fd_;
+	BlockReader			block_;		// Buffered mode
+	char*				map_;		// Mapped mode
+	size_t				mapLength_;
+	size_t				mapBegin_;	// first mapped byte not handed out yet
+
+	LineReader(const LineReader& other);
+	LineReader& operator=(const LineReader& other);
+
+	bool map();
+	void release();
+
+public:
+	LineReader();
+	~LineReader();	// unmaps and closes the file
+
+	bool open(const std::string& path, Mode mode = Buffered);
+
+	// The next line and its length; valid until the next call
+	bool next(const char*& line, size_t& length);
+
+	// True once a read error ended the input early
+	bool failed() const;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "OutputBuffer.hpp"
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+
+// "00" "01" ... "99": numbers are converted two digits per step
+static const char digitPairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+OutputBuffer::OutputBuffer(int fd, size_t capacity)
+	: fd_(fd), capacity_(capacity), data_(capacity), used_(0), written_(0) {}
+
+OutputBuffer::~OutputBuffer()
+{
+	flush();
+}
+
+void OutputBuffer::reserveRoom(size_t length)
+{
+	if (capacity_ - used_ < length)
+		flush();
+}
+
+bool OutputBuffer::flush()
+{
+	size_t done = 0;
+	while (done < used_)
+	{
+		ssize_t written = write(fd_, &data_[done], used_ - done);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+		{
+			written_ += done;
+			used_ = 0;
+			return false;
+		}
+		done += written;
+	}
+	written_ += done;
+	used_ = 0;
+	return true;
+}
+
+size_t OutputBuffer::tell() const
+{
+	return written_ + used_;
+}
+
+bool OutputBuffer::rewind(size_t position)
+{
+	if (position < written_ || position > written_ + used_)
+		return false;
+	used_ = position - written_;
+	return true;
+}
+
+void OutputBuffer::append(char c)
+{
+	reserveRoom(1);
+	data_[used_++] = c;
+}
+
+void OutputBuffer::append(const char* text)
+{
+	append(text, std::strlen(text));
+}
+
+void OutputBuffer::append(const char* text, size_t length)
+{
+	// Large blocks go out directly rather than through the buffer
+	if (length > capacity_)
+	{
+		flush();
+		while (length > 0)
+		{
+			ssize_t written = write(fd_, text, length);
+			if (written < 0 && errno == EINTR)
+				continue;
+			if (written <= 0)
+				return;
+			written_ += written;
+			text += written;
+			length -= written;
+		}
+		return;
+	}
+	reserveRoom(length);
+	std::memcpy(&data_[used_], text, length);
+	used_ += length;
+}
+
+void OutputBuffer::appendNumber(unsigned long value)
+{
+	reserveRoom(maxNumberLength);
+
+	// Digits are produced right to left into a scratch area, then copied
+	char scratch[maxNumberLength];
+	char* end = scratch + sizeof(scratch);
+	char* p = end;
+	while (value >= 100)
+	{
+		const char* pair = &digitPairs[(value % 100) * 2];
+		value /= 100;
+		*--p = pair[1];
+		*--p = pair[0];
+	}
+	if (value >= 10)
+	{
+		*--p = digitPairs[value * 2 + 1];
+		*--p = digitPairs[value * 2];
+	}
+	else
+		*--p = static_cast<char>('0' + value);
+
+	std::memcpy(&data_[used_], p, end - p);
+	used_ += end - p;
+}
+
+void OutputBuffer::appendNumber(long value)
+{
+	if (value < 0)
+	{
+		append('-');
+		// Negate in unsigned arithmetic so LONG_MIN is safe
+		appendNumber(0ul - static_cast<unsigned long>(value));
+	}
+	else
+		appendNumber(static_cast<unsigned long>(value));
+}
+
+// snprintf straight into the buffer; the long double conversion of a
+// double is exact, so "%.*Lf" prints it exactly as "%.*f" would
+void OutputBuffer::appendFloat(const char* format, int precision, long double value)
+{
+	reserveRoom(maxDecimalLength);
+	int length = snprintf(&data_[used_], maxDecimalLength, format, precision, value);
+	if (length < 0)
+		return;
+	if (static_cast<size_t>(length) >= maxDecimalLength)
+	{
+		std::vector<char> wide(length + 1);
+		snprintf(&wide[0], wide.size(), format, precision, value);
+		append(&wide[0], length);
+		return;
+	}
+	used_ += length;
+}
+
+void OutputBuffer::appendDecimal(long double value, int precision)
+{
+	appendFloat("%.*Lg", precision, value);
+}
+
+void OutputBuffer::appendFixed(double value, int precision)
+{
+	appendFloat("%.*Lf", precision, value);
+}
@@ -0,0 +1,65 @@
+#ifndef OUTPUTBUFFER_HPP
+# define OUTPUTBUFFER_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Text output formatted straight into one large buffer and handed to
+// write(2) only when it fills up or on flush(), so printing n numbers
+// costs a handful of system calls instead of n trips through iostreams.
+// Shared by btc, RPN and PmergeMe; the text is byte for byte what the
+// equivalent std::cout insertion would have produced.
+class OutputBuffer
+{
+public:
+	static const size_t defaultCapacity = 1 << 20;
+
+private:
+	// Longest thing appendNumber() writes in one go: a 64-bit number with sign
+	static const size_t maxNumberLength = 21;
+
+	// Room for one formatted floating-point value; longer ones are
+	// formatted again straight into a buffer of the right size
+	static const size_t maxDecimalLength = 64;
+
+	int					fd_;
+	size_t				capacity_;
+	std::vector<char>	data_;
+	size_t				used_;
+	size_t				written_;	// bytes already handed to write(2)
+
+	OutputBuffer();
+	OutputBuffer(const OutputBuffer& other);
+	OutputBuffer& operator=(const OutputBuffer& other);
+
+	void reserveRoom(size_t length);
+	void appendFloat(const char* format, int precision, long double value);
+
+public:
+	explicit OutputBuffer(int fd, size_t capacity = defaultCapacity);
+	~OutputBuffer();	// flushes
+
+	void append(char c);
+	void append(const char* text);
+	void append(const char* text, size_t length);
+	void appendNumber(long value);
+	void appendNumber(unsigned long value);
+
+	// As std::cout << value with the default flags at this precision
+	// (printf "%.*Lg": significant digits, trailing zeros dropped)
+	void appendDecimal(long double value, int precision = 6);
+
+	// As std::cout << std::fixed << std::setprecision(precision) << value
+	void appendFixed(double value, int precision);
+
+	// Returns false if the descriptor stopped accepting data
+	bool flush();
+
+	// Bytes appended so far. rewind() drops everything appended after
+	// `position`, which only works while those bytes are still buffered:
+	// it returns false, and drops nothing, once some were written out.
+	size_t tell() const;
+	bool rewind(size_t position);
+};
+
+#endif
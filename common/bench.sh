@@ -0,0 +1,157 @@
+#!/bin/bash
+
+# Shared helpers for the "make bench" performance regression suites.
+# A suite sources this file, generates its workloads once into
+# BENCH_DIR, then reports every stage with bench_time (times a command)
+# or bench_record (a time measured elsewhere). Each stage's throughput,
+# in units per second, is compared with the suite's baseline file: a
+# stage more than BENCH_TOLERANCE percent below its baseline fails.
+#
+#   BENCH_TOLERANCE=N   allowed slowdown in percent (default 30)
+#   BENCH_REPS=N        runs per timed stage, the fastest counts (default 3)
+#   BENCH_UPDATE=1      write the measured values as the new baseline
+#   BENCH_DIR=DIR       where generated workloads are kept (default bench_data)
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+BENCH_TOLERANCE=${BENCH_TOLERANCE:-30}
+BENCH_REPS=${BENCH_REPS:-3}
+BENCH_UPDATE=${BENCH_UPDATE:-0}
+BENCH_DIR=${BENCH_DIR:-bench_data}
+
+BENCH_BASELINE=""
+BENCH_MEASURED=""
+BENCH_FAILED=0
+BENCH_MISSING=0
+BENCH_ERRORS=0
+
+# Deterministic pseudo-random numbers for awk generators, identical on
+# every awk: Park-Miller minimal standard, exact in double precision.
+# Seed with lcg_state = S (1 <= S < 2147483647).
+BENCH_AWK_LCG='
+function lcg_next() { lcg_state = (lcg_state * 16807) % 2147483647; return lcg_state }
+function lcg_below(n) { return lcg_next() % n }
+'
+
+# Function to start a suite against its baseline file
+bench_init() {
+    BENCH_BASELINE="$1"
+    mkdir -p "$BENCH_DIR" || exit 1
+    echo -e "${BLUE}=== $2 ===${NC}"
+    printf "%-28s %12s %12s %16s %16s %8s\n" "stage" "units" "seconds" "units/s" "baseline" "change"
+}
+
+# Function to report a workload that ran but produced the wrong result
+bench_error() {
+    echo -e "${RED}✗ FAIL${NC} | $1"
+    BENCH_ERRORS=$((BENCH_ERRORS + 1))
+}
+
+# Function to print the current time in nanoseconds
+bench_now() {
+    date +%s%N
+}
+
+# Function to compare one measured stage with its baseline
+# Usage: bench_record NAME UNITS SECONDS
+bench_record() {
+    local name="$1"
+    local units="$2"
+    local seconds="$3"
+    local rate baseline verdict
+
+    rate=$(awk -v u="$units" -v s="$seconds" 'BEGIN { if (s <= 0) s = 1e-9; printf "%.0f", u / s }')
+    BENCH_MEASURED="${BENCH_MEASURED}${name} ${rate}"$'\n'
+    baseline=""
+    if [ -f "$BENCH_BASELINE" ]; then
+        baseline=$(awk -v n="$name" '$1 == n { print $2 }' "$BENCH_BASELINE")
+    fi
+
+    if [ -z "$baseline" ]; then
+        BENCH_MISSING=$((BENCH_MISSING + 1))
+        printf "%-28s %12s %12.6f %16s %16s " "$name" "$units" "$seconds" "$rate" "-"
+        echo -e "${YELLOW}    new${NC}"
+        return
+    fi
+
+    # Throughput below baseline * (100 - tolerance) / 100 is a regression
+    verdict=$(awk -v r="$rate" -v b="$baseline" -v t="$BENCH_TOLERANCE" \
+        'BEGIN { printf "%+.1f%% %s", (r - b) * 100 / b, (r * 100 < b * (100 - t)) ? "FAIL" : "ok" }')
+    printf "%-28s %12s %12.6f %16s %16s " "$name" "$units" "$seconds" "$rate" "$baseline"
+    if [ "${verdict##* }" = "FAIL" ]; then
+        BENCH_FAILED=$((BENCH_FAILED + 1))
+        echo -e "${RED}${verdict% *} ✗${NC}"
+    else
+        echo -e "${GREEN}${verdict% *} ✓${NC}"
+    fi
+}
+
+# Function to run a command BENCH_REPS times, keeping the fastest run in
+# BENCH_LAST_NS (nanoseconds); output is discarded
+# Usage: bench_measure NAME COMMAND [ARGS...]
+bench_measure() {
+    local name="$1"
+    shift
+    local best=""
+    local rep start end elapsed
+
+    for ((rep = 0; rep < BENCH_REPS; rep++)); do
+        start=$(bench_now)
+        if ! "$@" >/dev/null 2>&1; then
+            bench_error "$name: command failed: $*"
+            return 1
+        fi
+        end=$(bench_now)
+        elapsed=$((end - start))
+        if [ -z "$best" ] || [ "$elapsed" -lt "$best" ]; then
+            best=$elapsed
+        fi
+    done
+    BENCH_LAST_NS=$best
+}
+
+# Function to print nanoseconds as seconds
+bench_seconds() {
+    awk -v ns="$1" 'BEGIN { printf "%.6f", ns / 1e9 }'
+}
+
+# Function to time a command and record its fastest run
+# Usage: bench_time NAME UNITS COMMAND [ARGS...]
+bench_time() {
+    local name="$1"
+    local units="$2"
+    shift 2
+
+    bench_measure "$name" "$@" || return 1
+    bench_record "$name" "$units" "$(bench_seconds "$BENCH_LAST_NS")"
+}
+
+# Function to write the baseline if asked, print the verdict and exit
+bench_finish() {
+    if [ $BENCH_ERRORS -gt 0 ]; then
+        echo -e "${RED}$BENCH_ERRORS stage(s) could not be measured${NC}"
+        exit 1
+    fi
+    if [ "$BENCH_UPDATE" = "1" ]; then
+        {
+            echo "# stage units_per_second (written by BENCH_UPDATE=1; compared with BENCH_TOLERANCE)"
+            printf "%s" "$BENCH_MEASURED"
+        } > "$BENCH_BASELINE"
+        echo -e "${BLUE}Baseline written to $BENCH_BASELINE${NC}"
+        exit 0
+    fi
+    if [ $BENCH_MISSING -gt 0 ]; then
+        echo -e "${YELLOW}$BENCH_MISSING stage(s) have no baseline yet: run with BENCH_UPDATE=1${NC}"
+    fi
+    if [ $BENCH_FAILED -gt 0 ]; then
+        echo -e "${RED}$BENCH_FAILED stage(s) regressed by more than ${BENCH_TOLERANCE}%${NC}"
+        exit 1
+    fi
+    echo -e "${GREEN}No stage regressed by more than ${BENCH_TOLERANCE}%${NC}"
+    exit 0
+}
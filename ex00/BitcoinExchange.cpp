@@ -1,9 +1,9 @@
 #include "BitcoinExchange.hpp"
-#include <fstream>
-#include <sstream>
+#include "LineReader.hpp"
 #include <iostream>
 #include <limits>
 #include <cstdlib>
+#include <cstring>
 
 BitcoinExchange::BitcoinExchange(const std::string &csvPath) {
     loadCsvDatabase(csvPath);
@@ -12,12 +12,14 @@ BitcoinExchange::BitcoinExchange(const std::string &csvPath) {
 BitcoinExchange::~BitcoinExchange() {
 }
 
-BitcoinExchange::BitcoinExchange(const BitcoinExchange &other) : rates_(other.rates_) {
+BitcoinExchange::BitcoinExchange(const BitcoinExchange &other)
+    : rates_(other.rates_), samples_(other.samples_) {
 }
 
 BitcoinExchange &BitcoinExchange::operator=(const BitcoinExchange &other) {
     if (this != &other) {
         rates_ = other.rates_;
+        samples_ = other.samples_;
     }
     return *this;
 }
@@ -42,16 +44,114 @@ long double BitcoinExchange::rateOnOrBefore(const std::string &date) const {
     return it->second;
 }
 
+// Bracket formed by the first `count` samples (count >= 1): the last of
+// them and the one after it, if any
+void BitcoinExchange::bracketAt(size_t count, RateBracket &bracket) const {
+    const Sample &before = samples_[count - 1];
+    const Sample &after = (count < samples_.size()) ? samples_[count] : before;
+    bracket.beforeDay = before.day;
+    bracket.beforeRate = before.rate;
+    bracket.afterDay = after.day;
+    bracket.afterRate = after.rate;
+}
+
+long double BitcoinExchange::interpolate(const RateBracket &bracket, long double day) {
+    if (bracket.afterDay == bracket.beforeDay || day <= bracket.beforeDay) {
+        return bracket.beforeRate;
+    }
+    long double weight = (day - bracket.beforeDay) / (bracket.afterDay - bracket.beforeDay);
+    return bracket.beforeRate + (bracket.afterRate - bracket.beforeRate) * weight;
+}
+
+// Samples dated at or before `day`: the index of the first one after it
+size_t BitcoinExchange::samplesThrough(long double day) const {
+    size_t low = 0;
+    size_t high = samples_.size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (samples_[mid].day <= day) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// One binary search finds both neighbours: the first sample after `day`
+// and the one before it
+bool BitcoinExchange::rateBracket(long double day, RateBracket &bracket) const {
+    size_t count = samplesThrough(day);
+    if (count == 0) {
+        return false;
+    }
+    bracketAt(count, bracket);
+    return true;
+}
+
+void BitcoinExchange::ratesOnOrBefore(const std::vector<long> &days,
+                                      std::vector<long double> &rates,
+                                      std::vector<bool> &found) const {
+    rates.assign(days.size(), 0);
+    found.assign(days.size(), false);
+
+    for (size_t i = 0; i < days.size(); ++i) {
+        size_t count = samplesThrough(days[i]);
+        if (count > 0) {
+            rates[i] = samples_[count - 1].rate;
+            found[i] = true;
+        }
+    }
+}
+
+long double BitcoinExchange::interpolatedRate(long double day) const {
+    RateBracket bracket;
+    if (!rateBracket(day, bracket)) {
+        throw std::runtime_error("No rate available before the first sample");
+    }
+    return interpolate(bracket, day);
+}
+
+// The cursor counts the samples at or before the current time; since the
+// times ascend it only moves forward
+void BitcoinExchange::interpolatedRates(const std::vector<long double> &days,
+                                        std::vector<long double> &rates,
+                                        std::vector<bool> &found) const {
+    rates.assign(days.size(), 0);
+    found.assign(days.size(), false);
+
+    size_t cursor = 0;
+    for (size_t i = 0; i < days.size(); ++i) {
+        if (i > 0 && days[i] < days[i - 1]) {
+            throw std::runtime_error("Interpolation times must be in ascending order");
+        }
+        while (cursor < samples_.size() && samples_[cursor].day <= days[i]) {
+            ++cursor;
+        }
+        if (cursor == 0) {
+            continue;
+        }
+
+        RateBracket bracket;
+        bracketAt(cursor, bracket);
+        rates[i] = interpolate(bracket, days[i]);
+        found[i] = true;
+    }
+}
+
 void BitcoinExchange::loadCsvDatabase(const std::string &csvPath) {
-    std::ifstream file(csvPath.c_str());
-    if (!file.is_open()) {
+    LineReader file;
+    if (!file.open(csvPath, LineReader::Mapped)) {
         throw std::runtime_error("Error: could not open database file.");
     }
 
+    const char *text;
+    size_t length;
     std::string line;
     bool firstLine = true;
     
-    while (std::getline(file, line)) {
+    while (file.next(text, length)) {
+        line.assign(text, length);
         if (firstLine) {
             firstLine = false;
             if (line == "date,exchange_rate") {
@@ -100,14 +200,32 @@ void BitcoinExchange::loadCsvDatabase(const std::string &csvPath) {
         rates_[dateStr] = rate;
     }
 
-    file.close();
     if (rates_.empty()) {
         throw std::runtime_error("Error: no valid entries in database.");
     }
+
+    // YYYY-MM-DD keys sort chronologically, so the samples come out ascending
+    samples_.reserve(rates_.size());
+    for (std::map<std::string, long double>::const_iterator it = rates_.begin(); it != rates_.end(); ++it) {
+        Sample sample;
+        dayNumber(it->first, sample.day);
+        sample.rate = it->second;
+        samples_.push_back(sample);
+    }
 }
 
 bool BitcoinExchange::isValidDate(const std::string &date) {
-    if (date.length() != 10) {
+    return isValidDate(date.data(), date.length());
+}
+
+bool BitcoinExchange::isValidDate(const char *date, size_t length) {
+    int year, month, day;
+    return parseValidDate(date, length, year, month, day);
+}
+
+// YYYY-MM-DD with every field in range; the fields are read digit by digit
+bool BitcoinExchange::parseValidDate(const char *date, size_t length, int &year, int &month, int &day) {
+    if (length != 10) {
         return false;
     }
     
@@ -117,17 +235,16 @@ bool BitcoinExchange::isValidDate(const std::string &date) {
     }
 
     // Check all other characters are digits
-    for (size_t i = 0; i < date.length(); ++i) {
+    for (size_t i = 0; i < length; ++i) {
         if (i == 4 || i == 7) continue;
         if (date[i] < '0' || date[i] > '9') {
             return false;
         }
     }
 
-    int year, month, day;
-    if (!BitcoinExchange::parseDateComponents(date, year, month, day)) {
-        return false;
-    }
+    year = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0');
+    month = (date[5] - '0') * 10 + (date[6] - '0');
+    day = (date[8] - '0') * 10 + (date[9] - '0');
 
     // Validate ranges
     if (year < 1 || month < 1 || month > 12 || day < 1) {
@@ -160,6 +277,29 @@ bool BitcoinExchange::parseDateComponents(const std::string &date, int &year, in
     return true;
 }
 
+bool BitcoinExchange::dayNumber(const std::string &date, long &day) {
+    return dayNumber(date.data(), date.length(), day);
+}
+
+bool BitcoinExchange::dayNumber(const char *date, size_t length, long &day) {
+    int year, month, dayOfMonth;
+    if (!parseValidDate(date, length, year, month, dayOfMonth)) {
+        return false;
+    }
+
+    day = dayNumber(year, month, dayOfMonth);
+    return true;
+}
+
+long BitcoinExchange::dayNumber(int year, int month, int day) {
+    long past = year - 1;
+    long days = past * 365 + past / 4 - past / 100 + past / 400;
+    for (int m = 1; m < month; ++m) {
+        days += getDaysInMonth(m, year);
+    }
+    return days + day - 1;
+}
+
 bool BitcoinExchange::isLeapYear(int year) {
     return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
 }
@@ -218,12 +358,16 @@ bool BitcoinExchange::isValidCsvRate(const std::string &rateStr, long double &ra
 }
 
 bool BitcoinExchange::isValidInputValue(const std::string &valueStr, long double &value) {
-    if (valueStr.empty()) {
+    return isValidInputValue(valueStr.data(), valueStr.length(), value);
+}
+
+bool BitcoinExchange::isValidInputValue(const char *valueStr, size_t length, long double &value) {
+    if (length == 0) {
         return false;
     }
 
     // Check for invalid characters (allow minus sign at start)
-    for (size_t i = 0; i < valueStr.length(); ++i) {
+    for (size_t i = 0; i < length; ++i) {
         char c = valueStr[i];
         if (c != '.' && (c < '0' || c > '9') && !(i == 0 && c == '-')) {
             return false;
@@ -232,7 +376,7 @@ bool BitcoinExchange::isValidInputValue(const std::string &valueStr, long double
 
     // Check for multiple decimal points
     size_t decimalCount = 0;
-    for (size_t i = 0; i < valueStr.length(); ++i) {
+    for (size_t i = 0; i < length; ++i) {
         if (valueStr[i] == '.') {
             decimalCount++;
         }
@@ -241,8 +385,21 @@ bool BitcoinExchange::isValidInputValue(const std::string &valueStr, long double
         return false;
     }
 
+    // strtold needs a terminated copy; short values, the usual case, stay
+    // on the stack
+    char local[64];
+    std::string heap;
+    const char *text = local;
+    if (length < sizeof(local)) {
+        std::memcpy(local, valueStr, length);
+        local[length] = '\0';
+    } else {
+        heap.assign(valueStr, length);
+        text = heap.c_str();
+    }
+
     char *endptr;
-    value = std::strtold(valueStr.c_str(), &endptr);
+    value = std::strtold(text, &endptr);
     
     // Check if entire string was consumed
     if (*endptr != '\0') {
@@ -3,10 +3,20 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <stdexcept>
 
 class BitcoinExchange {
 public:
+    // The two samples around a point in time. Past the last sample both
+    // sides are that sample, so the rate stays flat as in rateOnOrBefore.
+    struct RateBracket {
+        long beforeDay;
+        long double beforeRate;
+        long afterDay;
+        long double afterRate;
+    };
+
     explicit BitcoinExchange(const std::string &csvPath = "data.csv");
     ~BitcoinExchange();
     BitcoinExchange(const BitcoinExchange &other);
@@ -15,18 +25,54 @@ public:
     bool hasRateOnOrBefore(const std::string &date) const;
     long double rateOnOrBefore(const std::string &date) const;
 
-    // Static utility functions for date and number validation
+    // Batch form of rateOnOrBefore for day numbers in any order, one
+    // binary search each; found[i] is false where hasRateOnOrBefore is
+    void ratesOnOrBefore(const std::vector<long> &days,
+                         std::vector<long double> &rates,
+                         std::vector<bool> &found) const;
+
+    // Interpolated lookups. Times are day numbers (see dayNumber) plus a
+    // fraction of a day for intraday points; the rate is interpolated
+    // linearly in time between the samples on either side.
+    bool rateBracket(long double day, RateBracket &bracket) const;
+    long double interpolatedRate(long double day) const;
+
+    // Batch form for ascending times: one merge-style pass over the
+    // samples, O(n + m). found[i] is false where no sample precedes days[i].
+    void interpolatedRates(const std::vector<long double> &days,
+                           std::vector<long double> &rates,
+                           std::vector<bool> &found) const;
+
+    // Static utility functions for date and number validation. The
+    // pointer + length forms take text that need not be NUL-terminated,
+    // such as a slice of a larger buffer; the string forms call them.
     static bool isValidDate(const std::string &date);
+    static bool isValidDate(const char *date, size_t length);
     static bool isValidCsvRate(const std::string &rateStr, long double &rate);
     static bool isValidInputValue(const std::string &valueStr, long double &value);
+    static bool isValidInputValue(const char *valueStr, size_t length, long double &value);
     static bool isLeapYear(int year);
     static int getDaysInMonth(int month, int year);
     static bool parseDateComponents(const std::string &date, int &year, int &month, int &day);
+    // Days since 0001-01-01 (day 0) for a valid YYYY-MM-DD date
+    static bool dayNumber(const std::string &date, long &day);
+    static bool dayNumber(const char *date, size_t length, long &day);
+    static long dayNumber(int year, int month, int day);
 
 private:
+    struct Sample {
+        long day;
+        long double rate;
+    };
+
     std::map<std::string, long double> rates_;
-    
+    std::vector<Sample> samples_;   // the same rates by day number, ascending
+
     void loadCsvDatabase(const std::string &csvPath);
+    size_t samplesThrough(long double day) const;
+    void bracketAt(size_t count, RateBracket &bracket) const;
+    static long double interpolate(const RateBracket &bracket, long double day);
+    static bool parseValidDate(const char *date, size_t length, int &year, int &month, int &day);
 };
 
 #endif
@@ -0,0 +1,228 @@
+#include "ValuationBatch.hpp"
+#include <limits>
+
+ValuationBatch::ValuationBatch(const BitcoinExchange &exchange, size_t capacity)
+    : exchange_(exchange), capacity_(capacity > 0 ? capacity : 1) {
+    text_.reserve(capacity_ * 32);
+    lineStart_.reserve(capacity_);
+    lineLength_.reserve(capacity_);
+    dateLength_.reserve(capacity_);
+    valueStart_.reserve(capacity_);
+    valueLength_.reserve(capacity_);
+    status_.reserve(capacity_);
+    day_.reserve(capacity_);
+    value_.reserve(capacity_);
+    result_.reserve(capacity_);
+}
+
+ValuationBatch::~ValuationBatch() {
+}
+
+// Orthodox Canonical Form - a batch is bound to its exchange, so it isn't copied
+ValuationBatch::ValuationBatch(const ValuationBatch &other)
+    : exchange_(other.exchange_), capacity_(other.capacity_) {
+}
+
+ValuationBatch &ValuationBatch::operator=(const ValuationBatch &other) {
+    (void)other;
+    return *this;
+}
+
+bool ValuationBatch::full() const {
+    return status_.size() >= capacity_;
+}
+
+bool ValuationBatch::empty() const {
+    return status_.empty();
+}
+
+void ValuationBatch::add(const char *line, size_t length) {
+    lineStart_.push_back(text_.size());
+    lineLength_.push_back(length);
+    text_.insert(text_.end(), line, line + length);
+    text_.push_back('\n');              // keeps &text_[0] valid for empty lines
+    dateLength_.push_back(0);
+    valueStart_.push_back(0);
+    valueLength_.push_back(0);
+    status_.push_back(Pending);
+    day_.push_back(-1);
+    value_.push_back(0);
+    result_.push_back(0);
+}
+
+void ValuationBatch::clear() {
+    text_.clear();
+    lineStart_.clear();
+    lineLength_.clear();
+    dateLength_.clear();
+    valueStart_.clear();
+    valueLength_.clear();
+    status_.clear();
+    day_.clear();
+    value_.clear();
+    result_.clear();
+}
+
+void ValuationBatch::run() {
+    if (empty()) {
+        return;
+    }
+    splitLines();
+    parseDates();
+    parseValues();
+    checkBounds();
+    lookupRates();
+    multiply();
+}
+
+// Position of the first " | " at or after `from`, or `length` if none
+static size_t findSeparator(const char *line, size_t from, size_t length) {
+    for (size_t i = from; i + 3 <= length; ++i) {
+        if (line[i] == ' ' && line[i + 1] == '|' && line[i + 2] == ' ') {
+            return i;
+        }
+    }
+    return length;
+}
+
+// Exact format "YYYY-MM-DD | value": one separator, no empty side and no
+// space at either end of either side
+void ValuationBatch::splitLines() {
+    for (size_t i = 0; i < status_.size(); ++i) {
+        const char *line = &text_[0] + lineStart_[i];
+        size_t length = lineLength_[i];
+
+        size_t pipe = findSeparator(line, 0, length);
+        if (pipe == length || findSeparator(line, pipe + 3, length) != length) {
+            status_[i] = BadInput;
+            continue;
+        }
+
+        size_t valueLength = length - pipe - 3;
+        const char *value = line + pipe + 3;
+        if (pipe == 0 || valueLength == 0 || line[0] == ' ' || line[pipe - 1] == ' ' ||
+            value[0] == ' ' || value[valueLength - 1] == ' ') {
+            status_[i] = BadInput;
+            continue;
+        }
+        dateLength_[i] = pipe;
+        valueStart_[i] = lineStart_[i] + pipe + 3;
+        valueLength_[i] = valueLength;
+    }
+}
+
+void ValuationBatch::parseDates() {
+    for (size_t i = 0; i < status_.size(); ++i) {
+        if (status_[i] != Pending) {
+            continue;
+        }
+        const char *date = &text_[0] + lineStart_[i];
+        if (!BitcoinExchange::dayNumber(date, dateLength_[i], day_[i])) {
+            status_[i] = BadInput;
+        }
+    }
+}
+
+void ValuationBatch::parseValues() {
+    for (size_t i = 0; i < status_.size(); ++i) {
+        if (status_[i] != Pending) {
+            continue;
+        }
+        const char *value = &text_[0] + valueStart_[i];
+        if (!BitcoinExchange::isValidInputValue(value, valueLength_[i], value_[i])) {
+            status_[i] = BadInput;
+        }
+    }
+}
+
+void ValuationBatch::checkBounds() {
+    for (size_t i = 0; i < status_.size(); ++i) {
+        if (status_[i] != Pending) {
+            continue;
+        }
+        if (value_[i] < 0) {
+            status_[i] = NotPositive;
+        } else if (value_[i] > 1000) {
+            status_[i] = TooLarge;
+        }
+    }
+}
+
+// Rows already rejected have day -1, which no sample precedes
+void ValuationBatch::lookupRates() {
+    for (size_t i = 0; i < status_.size(); ++i) {
+        if (status_[i] != Pending) {
+            day_[i] = -1;
+        }
+    }
+    exchange_.ratesOnOrBefore(day_, rate_, found_);
+    for (size_t i = 0; i < status_.size(); ++i) {
+        if (status_[i] == Pending && !found_[i]) {
+            status_[i] = NoRate;
+        }
+    }
+}
+
+// Overflow-checked value * rate, as the line-by-line loop did it
+void ValuationBatch::multiply() {
+    const long double maxValue = std::numeric_limits<long double>::max();
+    const long double infinity = std::numeric_limits<long double>::infinity();
+
+    for (size_t i = 0; i < status_.size(); ++i) {
+        if (status_[i] != Pending) {
+            continue;
+        }
+        long double rate = rate_[i];
+        if (rate == 0) {
+            result_[i] = 0;
+            status_[i] = Valued;
+            continue;
+        }
+        if (value_[i] > maxValue / rate) {
+            status_[i] = Overflow;
+            continue;
+        }
+        long double result = value_[i] * rate;
+        if (result != result || result == infinity) {
+            status_[i] = Overflow;
+            continue;
+        }
+        result_[i] = result;
+        status_[i] = Valued;
+    }
+}
+
+void ValuationBatch::print(OutputBuffer &out) const {
+    for (size_t i = 0; i < status_.size(); ++i) {
+        const char *line = &text_[0] + lineStart_[i];
+
+        switch (status_[i]) {
+            case BadInput:
+                out.append("Error: bad input => ");
+                out.append(line, lineLength_[i]);
+                break;
+            case NotPositive:
+                out.append("Error: not a positive number.");
+                break;
+            case TooLarge:
+                out.append("Error: too large a number.");
+                break;
+            case NoRate:
+                out.append("Error: no rate available for ");
+                out.append(line, dateLength_[i]);
+                out.append('.');
+                break;
+            case Overflow:
+                out.append("Error: multiplication overflow.");
+                break;
+            default:
+                out.append(line, dateLength_[i]);
+                out.append(" => ");
+                out.append(&text_[0] + valueStart_[i], valueLength_[i]);
+                out.append(" = ");
+                out.appendDecimal(result_[i]);
+                break;
+        }
+        out.append('\n');
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef VALUATIONBATCH_HPP
+#define VALUATIONBATCH_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "BitcoinExchange.hpp"
+#include "OutputBuffer.hpp"
+
+// Values a block of input lines in stages instead of line by line.
+// add() copies each line into one text arena; run() then makes one pass
+// per stage over the columns (split, dates, values, bounds, rate lookup,
+// multiplication), each stage only touching the rows still pending; and
+// print() writes one output line per row, in input order, with exactly
+// the messages the line-by-line loop printed.
+class ValuationBatch {
+public:
+    // Outcome of a row, in the order the checks are made
+    enum Status {
+        Pending,        // passed every stage so far
+        BadInput,       // "Error: bad input => <line>"
+        NotPositive,    // "Error: not a positive number."
+        TooLarge,       // "Error: too large a number."
+        NoRate,         // "Error: no rate available for <date>."
+        Overflow,       // "Error: multiplication overflow."
+        Valued          // "<date> => <value> = <result>"
+    };
+
+    static const size_t defaultCapacity = 4096;
+
+    // full() once `capacity` rows were added; a capacity of 1 values every
+    // line on its own, as a line-by-line loop would
+    explicit ValuationBatch(const BitcoinExchange &exchange, size_t capacity = defaultCapacity);
+    ~ValuationBatch();
+
+    bool full() const;
+    bool empty() const;
+    void add(const char *line, size_t length);
+    void run();
+    void print(OutputBuffer &out) const;
+    void clear();
+
+private:
+    ValuationBatch(const ValuationBatch &other);
+    ValuationBatch &operator=(const ValuationBatch &other);
+
+    const BitcoinExchange &exchange_;
+    size_t capacity_;
+    std::vector<char> text_;            // every line of the batch, back to back
+
+    // One entry per row
+    std::vector<size_t> lineStart_;
+    std::vector<size_t> lineLength_;
+    std::vector<size_t> dateLength_;    // the date starts the line
+    std::vector<size_t> valueStart_;
+    std::vector<size_t> valueLength_;
+    std::vector<unsigned char> status_;
+    std::vector<long> day_;             // -1 until the date is valid
+    std::vector<long double> value_;
+    std::vector<long double> rate_;
+    std::vector<bool> found_;
+    std::vector<long double> result_;
+
+    void splitLines();
+    void parseDates();
+    void parseValues();
+    void checkBounds();
+    void lookupRates();
+    void multiply();
+};
+
+#endif
@@ -0,0 +1,95 @@
+#!/bin/bash
+
+# btc performance regression suite (run by "make bench")
+# Workloads: a rate database with as many rows as two years of per-minute
+# samples, and a million-line valuation input with about 5% bad lines.
+# btc keys rates by calendar day, so the database has one row per day
+# from 0001-01-01 onward instead of one per minute.
+
+source ../common/bench.sh
+
+RATES=${BENCH_RATES:-1051200}
+LINES=${BENCH_LINES:-1000000}
+BTC="$(pwd)/btc"
+
+if [ ! -x "$BTC" ]; then
+    echo -e "${RED}Error: btc executable not found. Please run 'make' first.${NC}"
+    exit 1
+fi
+
+bench_init "$(pwd)/bench_baseline.txt" "btc Performance Regression Suite"
+cd "$BENCH_DIR" || exit 1
+
+# Function to generate the rate database: consecutive days, random-walk rates
+generate_rates() {
+    awk -v n="$RATES" "$BENCH_AWK_LCG"'
+    function days(y, m) {
+        if (m == 2)
+            return ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0) ? 29 : 28
+        return (m == 4 || m == 6 || m == 9 || m == 11) ? 30 : 31
+    }
+    BEGIN {
+        lcg_state = 20090103
+        y = 1; m = 1; d = 1; cents = 100000
+        print "date,exchange_rate"
+        for (i = 0; i < n; i++) {
+            printf "%04d-%02d-%02d,%d.%02d\n", y, m, d, int(cents / 100), cents % 100
+            cents += lcg_below(2001) - 1000
+            if (cents < 1)
+                cents = 1
+            if (++d > days(y, m)) {
+                d = 1
+                if (++m > 12) {
+                    m = 1
+                    y++
+                }
+            }
+        }
+        print y > "rates_last_year.txt"
+    }' > data.csv
+}
+
+# Function to generate the valuation input; every line gives one output line
+generate_input() {
+    awk -v n="$LINES" -v last="$(cat rates_last_year.txt)" "$BENCH_AWK_LCG"'
+    BEGIN {
+        lcg_state = 42
+        print "date | value"
+        for (i = 0; i < n; i++) {
+            y = 1 + lcg_below(last - 1)
+            m = 1 + lcg_below(12)
+            d = 1 + lcg_below(28)
+            value = sprintf("%d.%02d", lcg_below(1000), lcg_below(100))
+            if (lcg_below(20) == 0) {
+                kind = lcg_below(5)
+                if (kind == 0) value = "-" value
+                else if (kind == 1) value = 1001 + lcg_below(1000)
+                else if (kind == 2) { m = 2; d = 30 }
+                else if (kind == 3) value = "abc"
+                else { printf "%04d-%02d-%02d %s\n", y, m, d, value; continue }
+            }
+            printf "%04d-%02d-%02d | %s\n", y, m, d, value
+        }
+    }' > "input_$LINES.txt"
+}
+
+if [ ! -f data.csv ] || [ "$(wc -l < data.csv)" -ne $((RATES + 1)) ]; then
+    generate_rates
+fi
+if [ ! -f "input_$LINES.txt" ]; then
+    generate_input
+fi
+echo "date | value" > header_only.txt
+
+# The output must have one line per input line (header excluded)
+produced=$("$BTC" "input_$LINES.txt" 2>/dev/null | wc -l)
+if [ "$produced" -ne "$LINES" ]; then
+    bench_error "btc printed $produced lines for $LINES input lines"
+fi
+
+# Loading the database alone, then whole runs. Valuation is not timed as
+# the difference of the two: that would add up the noise of both.
+bench_time "btc_load_rates" "$RATES" "$BTC" header_only.txt
+bench_time "btc_end_to_end" "$LINES" "$BTC" "input_$LINES.txt"
+
+bench_finish
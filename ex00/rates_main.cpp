@@ -0,0 +1,146 @@
+#include "BitcoinExchange.hpp"
+#include <iostream>
+#include <stdexcept>
+
+/*
+** Checks for the interpolated rate lookups (rateBracket, interpolatedRate,
+** interpolatedRates), run by run_tests.sh against test_rates.csv:
+**
+**     2020-01-01  100
+**     2020-01-11  200
+**     2020-01-12   50
+**     2020-02-01   80
+**
+** Every expected rate below is exact in binary, so results are compared
+** with ==. Prints one "PASS name" or "FAIL name: ..." line per check and
+** exits 1 if any failed.
+**
+** Usage: ./btc_rates test_rates.csv
+*/
+
+static int failures = 0;
+
+static void check(bool passed, const std::string &name) {
+    if (passed) {
+        std::cout << "PASS " << name << std::endl;
+    } else {
+        std::cout << "FAIL " << name << std::endl;
+        failures++;
+    }
+}
+
+static void checkRate(const BitcoinExchange &exchange, long double day,
+                      long double expected, const std::string &name) {
+    long double rate;
+    try {
+        rate = exchange.interpolatedRate(day);
+    } catch (const std::exception &e) {
+        std::cout << "FAIL " << name << ": " << e.what() << std::endl;
+        failures++;
+        return;
+    }
+    if (rate != expected) {
+        std::cout << "FAIL " << name << ": got " << rate << ", expected " << expected << std::endl;
+        failures++;
+        return;
+    }
+    check(true, name);
+}
+
+static bool throwsOnLookup(const BitcoinExchange &exchange, long double day) {
+    try {
+        exchange.interpolatedRate(day);
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " test_rates.csv" << std::endl;
+        return 1;
+    }
+
+    BitcoinExchange *exchange;
+    try {
+        exchange = new BitcoinExchange(argv[1]);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const long first = BitcoinExchange::dayNumber(2020, 1, 1);
+    const long second = BitcoinExchange::dayNumber(2020, 1, 11);
+    const long third = BitcoinExchange::dayNumber(2020, 1, 12);
+    const long last = BitcoinExchange::dayNumber(2020, 2, 1);
+
+    // Before the first sample there is nothing to interpolate from
+    BitcoinExchange::RateBracket bracket;
+    check(!exchange->rateBracket(first - 0.5L, bracket), "no bracket before the first sample");
+    check(throwsOnLookup(*exchange, first - 0.5L), "interpolatedRate throws before the first sample");
+    check(throwsOnLookup(*exchange, first - 365), "interpolatedRate throws a year before the first sample");
+
+    // On a sample day the rate is that sample's, as in rateOnOrBefore
+    checkRate(*exchange, first, 100, "rate on the first sample day");
+    checkRate(*exchange, second, 200, "rate on a middle sample day");
+    checkRate(*exchange, last, 80, "rate on the last sample day");
+    check(exchange->interpolatedRate(third) == exchange->rateOnOrBefore("2020-01-12"),
+          "sample day agrees with rateOnOrBefore");
+
+    // Between samples the rate moves linearly, including within a day
+    checkRate(*exchange, first + 2.5L, 125, "fractional day between samples");
+    checkRate(*exchange, second + 0.25L, 162.5L, "intraday between adjacent days");
+    checkRate(*exchange, third + 10, 65, "midpoint across a month boundary");
+    check(exchange->rateBracket(first + 2.5L, bracket) &&
+          bracket.beforeDay == first && bracket.afterDay == second,
+          "bracket encloses a time between samples");
+
+    // Past the last sample the rate stays flat
+    checkRate(*exchange, last + 0.75L, 80, "fraction of a day past the last sample");
+    checkRate(*exchange, last + 1000, 80, "long after the last sample");
+    check(exchange->rateBracket(last + 30, bracket) &&
+          bracket.beforeDay == last && bracket.afterDay == last,
+          "bracket past the last sample is the last sample on both sides");
+
+    // The batch form agrees with one lookup at a time over a grid of
+    // quarter days running from before the first sample to past the last
+    std::vector<long double> days;
+    for (long double day = first - 3; day <= last + 5; day += 0.25L) {
+        days.push_back(day);
+    }
+    days.push_back(last + 5);   // repeated times are still ascending
+
+    std::vector<long double> rates;
+    std::vector<bool> found;
+    exchange->interpolatedRates(days, rates, found);
+
+    bool agree = rates.size() == days.size() && found.size() == days.size();
+    for (size_t i = 0; agree && i < days.size(); ++i) {
+        bool single = exchange->rateBracket(days[i], bracket);
+        if (found[i] != single || (single && rates[i] != exchange->interpolatedRate(days[i]))) {
+            std::cout << "FAIL batch and single lookups agree: differ at day " << days[i] << std::endl;
+            failures++;
+            agree = false;
+        }
+    }
+    if (agree) {
+        check(true, "batch and single lookups agree");
+    }
+    check(!found[0] && found[days.size() - 1], "batch marks times before the first sample");
+
+    // The batch form only walks forward, so it refuses unsorted times
+    std::vector<long double> unsorted;
+    unsorted.push_back(second);
+    unsorted.push_back(first + 0.5L);
+    bool threw = false;
+    try {
+        exchange->interpolatedRates(unsorted, rates, found);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    check(threw, "batch throws on unsorted times");
+
+    delete exchange;
+    return failures > 0 ? 1 : 0;
+}
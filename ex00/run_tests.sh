@@ -0,0 +1,137 @@
+#!/bin/bash
+
+# btc Test Runner
+# Checks btc's batched output against line-by-line valuation (btc_lines),
+# and the interpolated rate lookups through btc_rates
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+# Counters
+TOTAL_TESTS=0
+PASSED_TESTS=0
+FAILED_TESTS=0
+
+# Check if btc executable exists
+if [ ! -f "./btc" ]; then
+    echo -e "${RED}Error: btc executable not found. Please run 'make' first.${NC}"
+    exit 1
+fi
+
+if [ ! -f "./btc_rates" ] || [ ! -f "./btc_lines" ]; then
+    echo -e "${RED}Error: test drivers not found. Please run 'make btc_rates btc_lines' first.${NC}"
+    exit 1
+fi
+
+echo -e "${BLUE}=== btc Test Suite ===${NC}"
+echo
+
+TMP_DIR=$(mktemp -d)
+trap 'rm -rf "$TMP_DIR"' EXIT
+
+# The awk LCG shared with the bench suites, for reproducible inputs
+source ../common/bench.sh
+
+# Function to compare btc's output (stdout and stderr) on an input file
+# with btc_lines' output on the same file, plus the expected line count
+run_test() {
+    local input="$1"
+    local lines="$2"
+    local description="$3"
+
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+
+    ./btc "$input" > "$TMP_DIR/batched" 2>&1
+    local exit_code=$?
+    ./btc_lines "$input" > "$TMP_DIR/by_line" 2>&1
+
+    if [[ $exit_code -eq 0 ]] && cmp -s "$TMP_DIR/batched" "$TMP_DIR/by_line" \
+        && [[ $(wc -l < "$TMP_DIR/batched") -eq $lines ]]; then
+        echo -e "${GREEN}✓ PASS${NC}: $description"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC}: $description"
+        echo -e "  Exit code: $exit_code, $(wc -l < "$TMP_DIR/batched") lines"
+        diff "$TMP_DIR/by_line" "$TMP_DIR/batched" | head -5 | sed 's/^/  /'
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+}
+
+# Function to generate a valuation input: a header, then valid lines
+# across data.csv's range mixed with lines from test_edge_cases.txt
+generate_input() {
+    awk -v n="$1" "$BENCH_AWK_LCG"'
+    BEGIN {
+        while ((getline line < "test_edge_cases.txt") > 0)
+            edge[edges++] = line
+        lcg_state = 4096
+        print "date | value"
+        for (i = 0; i < n; i++) {
+            if (lcg_below(4) == 0) {
+                print edge[lcg_below(edges)]
+                continue
+            }
+            y = 2008 + lcg_below(16)
+            m = 1 + lcg_below(12)
+            d = 1 + lcg_below(28)
+            kind = lcg_below(3)
+            if (kind == 0) value = lcg_below(1001)
+            else if (kind == 1) value = sprintf("%d.%02d", lcg_below(1000), lcg_below(100))
+            else value = sprintf("%d.%d", lcg_below(1011) - 5, lcg_below(10))
+            printf "%04d-%02d-%02d | %s\n", y, m, d, value
+        }
+    }'
+}
+
+# Lines are valued 4096 at a time; btc_lines values them one by one. Every
+# line gives one output line, so 9000 lines cross two batch boundaries and
+# the shorter inputs end on either side of one.
+echo -e "${BLUE}--- Batched against line-by-line valuation ---${NC}"
+for lines in 9000 4095 4096 4097 8192; do
+    generate_input $lines > "$TMP_DIR/input.txt"
+    run_test "$TMP_DIR/input.txt" $lines "$lines lines"
+done
+
+# Interpolated rate lookups: btc_rates runs one check per output line
+# against test_rates.csv (see rates_main.cpp)
+echo
+echo -e "${BLUE}--- Interpolated rates ---${NC}"
+./btc_rates test_rates.csv > "$TMP_DIR/rates.txt" 2>&1
+rates_exit=$?
+while read -r verdict description; do
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    if [[ "$verdict" == "PASS" ]]; then
+        echo -e "${GREEN}✓ PASS${NC}: $description"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC}: $description"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+done < "$TMP_DIR/rates.txt"
+
+# A crash would end the list early without a FAIL line
+if [[ $rates_exit -ne 0 ]] && ! grep -q '^FAIL' "$TMP_DIR/rates.txt"; then
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    echo -e "${RED}✗ FAIL${NC}: btc_rates exited with code $rates_exit"
+    FAILED_TESTS=$((FAILED_TESTS + 1))
+fi
+
+# Print summary
+echo
+echo -e "${BLUE}=== Test Summary ===${NC}"
+echo -e "Total tests: $TOTAL_TESTS"
+echo -e "${GREEN}Passed: $PASSED_TESTS${NC}"
+
+if [[ $FAILED_TESTS -gt 0 ]]; then
+    echo -e "${RED}Failed: $FAILED_TESTS${NC}"
+    echo -e "${YELLOW}Success rate: $(( (PASSED_TESTS * 100) / TOTAL_TESTS ))%${NC}"
+    exit 1
+else
+    echo -e "${GREEN}All tests passed! 🎉${NC}"
+    echo -e "${GREEN}Success rate: 100%${NC}"
+    exit 0
+fi
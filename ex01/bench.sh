@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# RPN performance regression suite (run by "make bench")
+# Million-token expressions are evaluated in-process by RPN_bench (one
+# argv string is capped at 128 KiB); the CLI itself is timed on the
+# longest expression an argument can carry.
+
+source ../common/bench.sh
+
+TOKENS=${BENCH_TOKENS:-1000000}
+CLI_TOKENS=60001
+
+if [ ! -x "./RPN" ] || [ ! -x "./RPN_bench" ]; then
+    echo -e "${RED}Error: RPN or RPN_bench not found. Please run 'make RPN RPN_bench' first.${NC}"
+    exit 1
+fi
+
+bench_init "$(pwd)/bench_baseline.txt" "RPN Performance Regression Suite"
+
+# Stages measured inside RPN_bench: "stage tokens seconds" per line
+if output=$(./RPN_bench "$TOKENS" "$BENCH_REPS"); then
+    while read -r name tokens seconds; do
+        bench_record "$name" "$tokens" "$seconds"
+    done <<< "$output"
+else
+    bench_error "RPN_bench: wrong result or failure"
+fi
+
+# End to end through the CLI: "1 1 + 1 + ..." with CLI_TOKENS tokens
+if [ ! -f "$BENCH_DIR/cli_$CLI_TOKENS.txt" ]; then
+    awk -v n="$CLI_TOKENS" 'BEGIN { printf "1"; for (i = 1; 2 * i < n; i++) printf " 1 +"; print "" }' \
+        > "$BENCH_DIR/cli_$CLI_TOKENS.txt"
+fi
+expr=$(cat "$BENCH_DIR/cli_$CLI_TOKENS.txt")
+if [ "$(./RPN "$expr" 2>&1)" != "$(((CLI_TOKENS + 1) / 2))" ]; then
+    bench_error "RPN gave a wrong result for the $CLI_TOKENS-token expression"
+fi
+bench_time "rpn_cli_argv" "$CLI_TOKENS" ./RPN "$expr"
+
+bench_finish
@@ -0,0 +1,104 @@
+#include "RPN.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <ctime>
+
+/*
+** Driver for the RPN performance regression suite (see bench.sh).
+** A million-token expression is far beyond what one argv string may
+** hold (128 KiB on Linux), so the large workloads are built here and
+** handed to RPN::evaluate directly.
+**
+** Usage: ./RPN_bench TOKENS REPS
+** Prints one "stage tokens seconds" line per workload, seconds being
+** the fastest of REPS runs. Exits 1 if a result is wrong.
+*/
+
+// Long operator chain: "5 7 + 3 - 2 * 2 / 7 + ...", stack depth 2
+static void buildChain(size_t tokens, std::string &expr, long &expected) {
+    static const char digits[] = "7322";
+    static const char ops[] = "+-*/";
+
+    expr = "5";
+    expected = 5;
+    for (size_t i = 0; 2 * i + 3 <= tokens; ++i) {
+        char digit = digits[i % 4];
+        char op = ops[i % 4];
+        expr += ' ';
+        expr += digit;
+        expr += ' ';
+        expr += op;
+
+        long operand = digit - '0';
+        if (op == '+') expected += operand;
+        else if (op == '-') expected -= operand;
+        else if (op == '*') expected *= operand;
+        else expected /= operand;
+    }
+}
+
+// Deep stack: every digit pushed first, then one '+' per pair
+static void buildDeep(size_t tokens, std::string &expr, long &expected) {
+    size_t count = (tokens + 1) / 2;
+
+    expr.clear();
+    expected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char digit = static_cast<char>('1' + i % 9);
+        if (i > 0) expr += ' ';
+        expr += digit;
+        expected += digit - '0';
+    }
+    for (size_t i = 1; i < count; ++i) {
+        expr += " +";
+    }
+}
+
+static bool timeStage(const char *name, const std::string &expr, long expected, size_t reps) {
+    RPN calculator;
+    double best = -1;
+
+    for (size_t rep = 0; rep < reps; ++rep) {
+        struct timespec start, end;
+        long result;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool ok = calculator.evaluate(expr, result);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        if (!ok || result != expected) {
+            std::cerr << "Error: " << name << " gave a wrong result" << std::endl;
+            return false;
+        }
+        double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        if (best < 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+
+    size_t tokens = (expr.size() + 1) / 2;
+    std::cout << name << " " << tokens << " " << std::fixed << best << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3 || std::atol(argv[1]) < 3 || std::atol(argv[2]) < 1) {
+        std::cerr << "Usage: " << argv[0] << " TOKENS REPS" << std::endl;
+        return 1;
+    }
+    size_t tokens = static_cast<size_t>(std::atol(argv[1]));
+    size_t reps = static_cast<size_t>(std::atol(argv[2]));
+
+    std::string expr;
+    long expected;
+
+    buildChain(tokens, expr, expected);
+    if (!timeStage("rpn_chain", expr, expected, reps)) {
+        return 1;
+    }
+    buildDeep(tokens, expr, expected);
+    if (!timeStage("rpn_deep_stack", expr, expected, reps)) {
+        return 1;
+    }
+    return 0;
+}
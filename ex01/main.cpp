@@ -1,5 +1,7 @@
 #include "RPN.hpp"
+#include "OutputBuffer.hpp"
 #include <iostream>
+#include <unistd.h>
 
 /*
 ** Test cases that must pass:
@@ -38,7 +40,9 @@ int main(int argc, char* argv[]) {
     long result;
     
     if (calculator.evaluate(argv[1], result)) {
-        std::cout << result << std::endl;
+        OutputBuffer out(STDOUT_FILENO);
+        out.appendNumber(result);
+        out.append('\n');
         return 0;
     } else {
         std::cerr << "Error" << std::endl;
@@ -0,0 +1,470 @@
+#include "Benchmark.hpp"
+#include "FordJohnson.hpp"
+#include "BlockList.hpp"
+#include "RadixPartition.hpp"
+#include "ParallelSort.hpp"
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <climits>
+
+// Orthodox Canonical Form - private constructors
+Benchmark::Benchmark() {}
+Benchmark::Benchmark(const Benchmark& other) { (void)other; }
+Benchmark& Benchmark::operator=(const Benchmark& other) { (void)other; return *this; }
+Benchmark::~Benchmark() {}
+
+Benchmark::Options::Options() : repetitions(5), warmup(1), seed(42), format(Csv)
+{
+	for (size_t n = 10; n <= 100000; n *= 10)
+		sizes.push_back(n);
+	distributions.push_back(Random);
+	distributions.push_back(Sorted);
+	distributions.push_back(Reversed);
+	distributions.push_back(FewUnique);
+	distributions.push_back(Sawtooth);
+	algorithms.push_back(MergeInsertionVector);
+	algorithms.push_back(MergeInsertionDeque);
+	algorithms.push_back(MergeInsertionFastVector);
+	algorithms.push_back(MergeInsertionBlockList);
+	algorithms.push_back(RadixPartitionVector);
+	algorithms.push_back(StdSort);
+	algorithms.push_back(StdStableSort);
+	jobs.push_back(1);
+}
+
+static const Benchmark::Distribution allDistributions[] = {
+	Benchmark::Random, Benchmark::Sorted, Benchmark::Reversed, Benchmark::FewUnique, Benchmark::Sawtooth
+};
+
+static const Benchmark::Algorithm allAlgorithms[] = {
+	Benchmark::MergeInsertionVector, Benchmark::MergeInsertionDeque, Benchmark::MergeInsertionFastVector,
+	Benchmark::MergeInsertionBlockList, Benchmark::RadixPartitionVector, Benchmark::StdSort,
+	Benchmark::StdStableSort,
+	Benchmark::BinaryInsertionVector, Benchmark::BinaryInsertionDeque, Benchmark::BinaryInsertionBlockList
+};
+
+const char* Benchmark::distributionName(Distribution distribution)
+{
+	switch (distribution)
+	{
+		case Random: return "random";
+		case Sorted: return "sorted";
+		case Reversed: return "reversed";
+		case FewUnique: return "few_unique";
+		case Sawtooth: return "sawtooth";
+	}
+	return "unknown";
+}
+
+const char* Benchmark::algorithmName(Algorithm algorithm)
+{
+	switch (algorithm)
+	{
+		case MergeInsertionVector: return "mi_vector";
+		case MergeInsertionDeque: return "mi_deque";
+		case MergeInsertionFastVector: return "mi_fast_vector";
+		case MergeInsertionBlockList: return "mi_blocklist";
+		case RadixPartitionVector: return "rp_vector";
+		case StdSort: return "std_sort";
+		case StdStableSort: return "std_stable_sort";
+		case BinaryInsertionVector: return "bi_vector";
+		case BinaryInsertionDeque: return "bi_deque";
+		case BinaryInsertionBlockList: return "bi_blocklist";
+	}
+	return "unknown";
+}
+
+// Positive decimal count without sign or leading zeros
+bool Benchmark::parseCount(const std::string& text, size_t& out)
+{
+	if (text.empty() || text.size() > 9 || text[0] == '0')
+		return false;
+	size_t value = 0;
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		if (text[i] < '0' || text[i] > '9')
+			return false;
+		value = value * 10 + (text[i] - '0');
+	}
+	out = value;
+	return true;
+}
+
+// Comma-separated list of counts
+bool Benchmark::parseCounts(const std::string& list, std::vector<size_t>& out)
+{
+	out.clear();
+	size_t start = 0;
+	while (start <= list.size())
+	{
+		size_t comma = list.find(',', start);
+		if (comma == std::string::npos)
+			comma = list.size();
+		size_t n;
+		if (!parseCount(list.substr(start, comma - start), n))
+			return false;
+		out.push_back(n);
+		start = comma + 1;
+	}
+	return true;
+}
+
+// Comma-separated list of names: fills `out` with matching entries of `all`
+template <typename Enum>
+static bool parseNames(const std::string& list, const Enum* all, size_t count,
+	const char* (*nameOf)(Enum), std::vector<Enum>& out)
+{
+	out.clear();
+	size_t start = 0;
+	while (start <= list.size())
+	{
+		size_t comma = list.find(',', start);
+		if (comma == std::string::npos)
+			comma = list.size();
+		std::string name = list.substr(start, comma - start);
+
+		size_t i = 0;
+		while (i < count && name != nameOf(all[i]))
+			i++;
+		if (i == count)
+			return false;
+		out.push_back(all[i]);
+		start = comma + 1;
+	}
+	return !out.empty();
+}
+
+bool Benchmark::parseOption(const std::string& arg, Options& options)
+{
+	size_t equals = arg.find('=');
+	if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos)
+		return false;
+	std::string name = arg.substr(2, equals - 2);
+	std::string value = arg.substr(equals + 1);
+
+	if (name == "sizes")
+		return parseCounts(value, options.sizes);
+	if (name == "jobs")
+	{
+		if (!parseCounts(value, options.jobs))
+			return false;
+		for (size_t i = 0; i < options.jobs.size(); i++)
+		{
+			if (options.jobs[i] > maxJobs)
+				return false;
+		}
+		return true;
+	}
+	if (name == "distributions")
+		return parseNames(value, allDistributions, sizeof(allDistributions) / sizeof(allDistributions[0]),
+			&distributionName, options.distributions);
+	if (name == "algorithms")
+		return parseNames(value, allAlgorithms, sizeof(allAlgorithms) / sizeof(allAlgorithms[0]),
+			&algorithmName, options.algorithms);
+	if (name == "reps")
+		return parseCount(value, options.repetitions);
+	if (name == "warmup")
+	{
+		if (value == "0")
+		{
+			options.warmup = 0;
+			return true;
+		}
+		return parseCount(value, options.warmup);
+	}
+	if (name == "seed")
+	{
+		size_t seed;
+		if (!parseCount(value, seed))
+			return false;
+		options.seed = static_cast<unsigned>(seed);
+		return true;
+	}
+	if (name == "format")
+	{
+		if (value == "csv")
+			options.format = Csv;
+		else if (value == "json")
+			options.format = Json;
+		else
+			return false;
+		return true;
+	}
+	return false;
+}
+
+bool Benchmark::parseArgs(int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (!parseOption(argv[i], options))
+			return false;
+	}
+	return true;
+}
+
+double Benchmark::elapsedMicros(const struct timespec& start, const struct timespec& end)
+{
+	return (end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_nsec - start.tv_nsec) / 1000.0;
+}
+
+// Deterministic inputs: the same seed gives the same numbers on every build
+void Benchmark::generate(Distribution distribution, size_t n, unsigned seed, std::vector<int>& out)
+{
+	out.resize(n);
+	unsigned state = seed | 1u;
+	size_t period = n / 8 > 0 ? n / 8 : 1;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		switch (distribution)
+		{
+			case Random: out[i] = static_cast<int>(state % INT_MAX) + 1; break;
+			case Sorted: out[i] = static_cast<int>(i) + 1; break;
+			case Reversed: out[i] = static_cast<int>(n - i); break;
+			case FewUnique: out[i] = static_cast<int>(state % 8) + 1; break;
+			case Sawtooth: out[i] = static_cast<int>(i % period) + 1; break;
+		}
+	}
+}
+
+template <typename Iterator>
+static bool isSorted(Iterator first, Iterator last)
+{
+	if (first == last)
+		return true;
+	for (Iterator next = first + 1; next != last; ++first, ++next)
+	{
+		if (*next < *first)
+			return false;
+	}
+	return true;
+}
+
+// Insertion-heavy reference workload: every element goes through one
+// binary search and one insert into the middle of the container
+template <typename Container>
+static void binaryInsertionSort(const std::vector<int>& input, Container& out)
+{
+	for (size_t i = 0; i < input.size(); i++)
+		out.insert(std::upper_bound(out.begin(), out.end(), input[i]), input[i]);
+}
+
+// The std baselines don't report comparisons; one extra untimed run does
+struct CountingLess
+{
+	size_t* count;
+	explicit CountingLess(size_t* c) : count(c) {}
+	bool operator()(int a, int b) const
+	{
+		++*count;
+		return a < b;
+	}
+};
+
+// Algorithms with a threaded mode: those are run once per --jobs entry
+bool Benchmark::threaded(Algorithm algorithm)
+{
+	return algorithm == MergeInsertionVector || algorithm == MergeInsertionDeque
+		|| algorithm == MergeInsertionFastVector || algorithm == MergeInsertionBlockList
+		|| algorithm == RadixPartitionVector;
+}
+
+bool Benchmark::timeOnce(Algorithm algorithm, size_t jobs, const std::vector<int>& input, double& micros,
+	SortStats& stats)
+{
+	struct timespec start, end;
+	std::vector<int> vectorData;
+	std::deque<int> dequeData;
+	BlockList<int> blockData;
+	size_t buckets;
+	bool sorted;
+
+	if (algorithm == MergeInsertionDeque)
+		dequeData.assign(input.begin(), input.end());
+	else if (algorithm == MergeInsertionBlockList)
+		blockData = BlockList<int>(input.begin(), input.end());
+	else if (algorithm != BinaryInsertionVector && algorithm != BinaryInsertionDeque
+		&& algorithm != BinaryInsertionBlockList)
+		vectorData = input;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	switch (algorithm)
+	{
+		case MergeInsertionVector:
+			stats = mergeInsertionSortParallel(vectorData, std::less<int>(), FewestComparisons, jobs);
+			break;
+		case MergeInsertionDeque:
+			stats = mergeInsertionSortParallel(dequeData, std::less<int>(), FewestComparisons, jobs);
+			break;
+		case MergeInsertionFastVector:
+			stats = mergeInsertionSortParallel(vectorData, std::less<int>(), FastestWallClock, jobs);
+			break;
+		case MergeInsertionBlockList:
+			stats = mergeInsertionSortParallel(blockData, std::less<int>(), FewestComparisons, jobs);
+			break;
+		case RadixPartitionVector:
+			stats = RadixPartition::sort(vectorData, FewestComparisons, jobs, buckets);
+			break;
+		case StdSort:
+			std::sort(vectorData.begin(), vectorData.end());
+			break;
+		case StdStableSort:
+			std::stable_sort(vectorData.begin(), vectorData.end());
+			break;
+		case BinaryInsertionVector:
+			binaryInsertionSort(input, vectorData);
+			break;
+		case BinaryInsertionDeque:
+			binaryInsertionSort(input, dequeData);
+			break;
+		case BinaryInsertionBlockList:
+			binaryInsertionSort(input, blockData);
+			break;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	micros = elapsedMicros(start, end);
+
+	if (algorithm == MergeInsertionDeque || algorithm == BinaryInsertionDeque)
+		sorted = isSorted(dequeData.begin(), dequeData.end()) && dequeData.size() == input.size();
+	else if (algorithm == MergeInsertionBlockList || algorithm == BinaryInsertionBlockList)
+		sorted = isSorted(blockData.begin(), blockData.end()) && blockData.size() == input.size();
+	else
+		sorted = isSorted(vectorData.begin(), vectorData.end()) && vectorData.size() == input.size();
+	return sorted;
+}
+
+bool Benchmark::measure(Algorithm algorithm, Distribution distribution, size_t jobs,
+	const std::vector<int>& input, const Options& options, Result& result)
+{
+	double micros;
+	SortStats stats;
+
+	for (size_t i = 0; i < options.warmup; i++)
+	{
+		if (!timeOnce(algorithm, jobs, input, micros, stats))
+			return false;
+	}
+
+	std::vector<double> samples;
+	for (size_t i = 0; i < options.repetitions; i++)
+	{
+		if (!timeOnce(algorithm, jobs, input, micros, stats))
+			return false;
+		samples.push_back(micros);
+	}
+
+	// Binary insertion doesn't report comparisons either; it isn't a
+	// comparison-count baseline, so its column stays 0. The memory columns
+	// only cover the merge-insertion sorts.
+	if (algorithm == StdSort || algorithm == StdStableSort)
+	{
+		std::vector<int> data = input;
+		stats.comparisons = 0;
+		if (algorithm == StdSort)
+			std::sort(data.begin(), data.end(), CountingLess(&stats.comparisons));
+		else
+			std::stable_sort(data.begin(), data.end(), CountingLess(&stats.comparisons));
+	}
+
+	std::sort(samples.begin(), samples.end());
+	size_t count = samples.size();
+	double total = 0;
+	for (size_t i = 0; i < count; i++)
+		total += samples[i];
+
+	result.algorithm = algorithm;
+	result.distribution = distribution;
+	result.size = input.size();
+	result.jobs = jobs;
+	result.comparisons = stats.comparisons;
+	result.allocations = stats.allocations;
+	result.peakBytes = stats.peakBytes;
+	result.minimum = samples[0];
+	result.median = (count % 2) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+	result.p99 = samples[(99 * count + 99) / 100 - 1];	// nearest rank
+	result.mean = total / count;
+	return true;
+}
+
+void Benchmark::printCsv(const std::vector<Result>& results)
+{
+	std::cout << "algorithm,distribution,size,jobs,comparisons,allocations,peak_bytes,"
+			  << "min_us,median_us,p99_us,mean_us" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& r = results[i];
+		std::cout << algorithmName(r.algorithm) << ',' << distributionName(r.distribution) << ','
+				  << r.size << ',' << r.jobs << ',' << r.comparisons << ',' << r.allocations << ',' << r.peakBytes << ','
+				  << r.minimum << ',' << r.median << ',' << r.p99 << ',' << r.mean << std::endl;
+	}
+}
+
+void Benchmark::printJson(const std::vector<Result>& results)
+{
+	std::cout << "[" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& r = results[i];
+		std::cout << "  {\"algorithm\": \"" << algorithmName(r.algorithm) << "\""
+				  << ", \"distribution\": \"" << distributionName(r.distribution) << "\""
+				  << ", \"size\": " << r.size
+				  << ", \"jobs\": " << r.jobs
+				  << ", \"comparisons\": " << r.comparisons
+				  << ", \"allocations\": " << r.allocations
+				  << ", \"peak_bytes\": " << r.peakBytes
+				  << ", \"min_us\": " << r.minimum
+				  << ", \"median_us\": " << r.median
+				  << ", \"p99_us\": " << r.p99
+				  << ", \"mean_us\": " << r.mean << "}"
+				  << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+	std::cout << "]" << std::endl;
+}
+
+bool Benchmark::run(const Options& options)
+{
+	std::vector<Result> results;
+	std::vector<int> input;
+
+	for (size_t s = 0; s < options.sizes.size(); s++)
+	{
+		for (size_t d = 0; d < options.distributions.size(); d++)
+		{
+			generate(options.distributions[d], options.sizes[s], options.seed, input);
+			for (size_t a = 0; a < options.algorithms.size(); a++)
+			{
+				Algorithm algorithm = options.algorithms[a];
+				size_t runs = threaded(algorithm) ? options.jobs.size() : 1;
+				for (size_t j = 0; j < runs; j++)
+				{
+					size_t jobs = threaded(algorithm) ? options.jobs[j] : 1;
+					Result result;
+					if (!measure(algorithm, options.distributions[d], jobs, input, options, result))
+					{
+						std::cerr << "Error: " << algorithmName(algorithm) << " left "
+								  << distributionName(options.distributions[d]) << " input of size "
+								  << options.sizes[s] << " unsorted with " << jobs << " jobs" << std::endl;
+						return false;
+					}
+					results.push_back(result);
+				}
+			}
+		}
+	}
+
+	if (options.format == Json)
+		printJson(results);
+	else
+		printCsv(results);
+	return true;
+}
@@ -0,0 +1,115 @@
+#ifndef BENCHMARK_HPP
+# define BENCHMARK_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <ctime>
+#include "ComparisonOracle.hpp"
+
+// Benchmark suite for the merge-insertion sort and the std baselines.
+// Every (algorithm, distribution, size) cell is run `warmup` times
+// untimed, then `repetitions` times around the sort call alone with
+// CLOCK_MONOTONIC; input generation and copies stay outside the clock.
+// The merge-insertion and radix sorts are also run once per --jobs entry,
+// for thread scaling; the other algorithms have no threaded mode and get
+// a single cell at jobs 1.
+class Benchmark
+{
+public:
+	enum Distribution
+	{
+		Random,
+		Sorted,
+		Reversed,
+		FewUnique,		// 8 distinct values
+		Sawtooth		// 8 ascending runs
+	};
+
+	enum Algorithm
+	{
+		MergeInsertionVector,
+		MergeInsertionDeque,
+		MergeInsertionFastVector,	// SortPolicy FastestWallClock
+		MergeInsertionBlockList,
+		RadixPartitionVector,		// RadixPartition buckets, each merge-insertion sorted
+		StdSort,
+		StdStableSort,
+		// Insertion-heavy workload, not in the default set: binary
+		// insertion sort, one upper_bound + insert per element
+		BinaryInsertionVector,
+		BinaryInsertionDeque,
+		BinaryInsertionBlockList
+	};
+
+	enum Format
+	{
+		Csv,
+		Json
+	};
+
+	// Command-line options, all given as "--name=value"
+	struct Options
+	{
+		std::vector<size_t>			sizes;			// --sizes=10,100,...
+		std::vector<Distribution>	distributions;	// --distributions=random,sorted,...
+		std::vector<Algorithm>		algorithms;		// --algorithms=mi_vector,std_sort,...
+		std::vector<size_t>			jobs;			// --jobs=1,2,4,... sorting threads
+		size_t						repetitions;	// --reps=N
+		size_t						warmup;			// --warmup=N
+		unsigned					seed;			// --seed=N
+		Format						format;			// --format=csv|json
+
+		Options();
+	};
+
+	// One table row: the timed samples of one cell, in microseconds
+	struct Result
+	{
+		Algorithm		algorithm;
+		Distribution	distribution;
+		size_t			size;
+		size_t			jobs;
+		size_t			comparisons;
+		size_t			allocations;
+		size_t			peakBytes;
+		double			minimum;
+		double			median;
+		double			p99;
+		double			mean;
+	};
+
+private:
+	// Orthodox Canonical Form - private constructors since this is a utility class
+	Benchmark();
+	Benchmark(const Benchmark& other);
+	Benchmark& operator=(const Benchmark& other);
+	~Benchmark();
+
+	static const char* distributionName(Distribution distribution);
+	static const char* algorithmName(Algorithm algorithm);
+	static const size_t maxJobs = 256;
+
+	static bool parseCount(const std::string& text, size_t& out);
+	static bool parseCounts(const std::string& list, std::vector<size_t>& out);
+	static bool threaded(Algorithm algorithm);
+	static bool parseOption(const std::string& arg, Options& options);
+
+	static double elapsedMicros(const struct timespec& start, const struct timespec& end);
+	static void generate(Distribution distribution, size_t n, unsigned seed, std::vector<int>& out);
+	static bool timeOnce(Algorithm algorithm, size_t jobs, const std::vector<int>& input, double& micros,
+		SortStats& stats);
+	static bool measure(Algorithm algorithm, Distribution distribution, size_t jobs,
+		const std::vector<int>& input, const Options& options, Result& result);
+
+	static void printCsv(const std::vector<Result>& results);
+	static void printJson(const std::vector<Result>& results);
+
+public:
+	static bool parseArgs(int argc, char** argv, Options& options);
+
+	// Returns false if any algorithm produced an unsorted result
+	static bool run(const Options& options);
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef BLOCKLIST_HPP
+# define BLOCKLIST_HPP
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+// Segmented sequence for insertion-heavy use (a tiered vector).
+// Elements live in equal-size blocks reached through an indexed block
+// directory. Every block except the last is full, so element i is always
+// in block i / B: random access is one directory lookup, like std::deque.
+// Each block is a ring buffer with its own head and fill count, so an
+// insert in the middle shifts at most half a block and then moves one
+// element across each later block in O(1) apiece: O(B + n / B) per insert.
+// B is a power of two kept near sqrt n: whenever the directory reaches 2B
+// blocks, the elements are regrouped into blocks twice as large. That
+// costs O(n) each time n quadruples, so O(1) amortized per element, and
+// keeps inserts at O(sqrt n).
+template <typename T>
+class BlockList
+{
+private:
+	struct Block
+	{
+		T*		items;	// blockSize() slots used as a ring
+		size_t	head;	// slot of the block's first element
+		size_t	count;	// fill count
+	};
+
+	// Blocks start at 64 slots
+	static const size_t minBlockShift = 6;
+
+	std::vector<Block>	directory_;
+	size_t				size_;
+	size_t				shift_;		// log2 of the block size
+
+	size_t blockSize() const { return static_cast<size_t>(1) << shift_; }
+	size_t wrap(size_t slot) const { return slot & (blockSize() - 1); }
+
+	void reserveOne();
+	void addBlock();
+	void regroup(size_t shift);
+	void releaseBlocks();
+	void insertIntoBlock(Block& block, size_t offset, const T& value);
+
+public:
+	template <typename Owner, typename Value>
+	class Iterator
+	{
+	private:
+		Owner*	owner_;
+		size_t	index_;
+
+	public:
+		typedef std::random_access_iterator_tag	iterator_category;
+		typedef T								value_type;
+		typedef std::ptrdiff_t					difference_type;
+		typedef Value*							pointer;
+		typedef Value&							reference;
+
+		Iterator() : owner_(NULL), index_(0) {}
+		Iterator(Owner* owner, size_t index) : owner_(owner), index_(index) {}
+		template <typename OtherOwner, typename OtherValue>
+		Iterator(const Iterator<OtherOwner, OtherValue>& other) : owner_(other.owner()), index_(other.index()) {}
+
+		Owner* owner() const { return owner_; }
+		size_t index() const { return index_; }
+
+		reference operator*() const { return (*owner_)[index_]; }
+		pointer operator->() const { return &(*owner_)[index_]; }
+		reference operator[](difference_type n) const { return (*owner_)[index_ + n]; }
+
+		Iterator& operator++() { ++index_; return *this; }
+		Iterator& operator--() { --index_; return *this; }
+		Iterator operator++(int) { Iterator old(*this); ++index_; return old; }
+		Iterator operator--(int) { Iterator old(*this); --index_; return old; }
+		Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+		Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+		Iterator operator+(difference_type n) const { return Iterator(owner_, index_ + n); }
+		Iterator operator-(difference_type n) const { return Iterator(owner_, index_ - n); }
+		difference_type operator-(const Iterator& other) const
+		{
+			return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+		}
+
+		bool operator==(const Iterator& other) const { return index_ == other.index_; }
+		bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+		bool operator<(const Iterator& other) const { return index_ < other.index_; }
+		bool operator>(const Iterator& other) const { return index_ > other.index_; }
+		bool operator<=(const Iterator& other) const { return index_ <= other.index_; }
+		bool operator>=(const Iterator& other) const { return index_ >= other.index_; }
+	};
+
+	typedef T											value_type;
+	typedef size_t										size_type;
+	typedef Iterator<BlockList, T>						iterator;
+	typedef Iterator<const BlockList, const T>			const_iterator;
+
+	BlockList();
+	template <typename InputIterator>
+	BlockList(InputIterator first, InputIterator last);
+	BlockList(const BlockList& other);
+	BlockList& operator=(const BlockList& other);
+	~BlockList();
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	void clear();
+
+	T& operator[](size_t index)
+	{
+		Block& block = directory_[index >> shift_];
+		return block.items[wrap(block.head + index)];
+	}
+	const T& operator[](size_t index) const
+	{
+		const Block& block = directory_[index >> shift_];
+		return block.items[wrap(block.head + index)];
+	}
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, size_); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, size_); }
+
+	void push_back(const T& value);
+	iterator insert(iterator position, const T& value);
+};
+
+#include "BlockList.tpp"
+
+#endif
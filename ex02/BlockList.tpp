@@ -0,0 +1,196 @@
+#ifndef BLOCKLIST_TPP
+# define BLOCKLIST_TPP
+
+template <typename T>
+BlockList<T>::BlockList() : size_(0), shift_(minBlockShift) {}
+
+template <typename T>
+template <typename InputIterator>
+BlockList<T>::BlockList(InputIterator first, InputIterator last) : size_(0), shift_(minBlockShift)
+{
+	for (; first != last; ++first)
+		push_back(*first);
+}
+
+template <typename T>
+BlockList<T>::BlockList(const BlockList& other) : size_(0), shift_(minBlockShift)
+{
+	for (size_t i = 0; i < other.size_; i++)
+		push_back(other[i]);
+}
+
+template <typename T>
+BlockList<T>& BlockList<T>::operator=(const BlockList& other)
+{
+	if (this != &other)
+	{
+		clear();
+		for (size_t i = 0; i < other.size_; i++)
+			push_back(other[i]);
+	}
+	return *this;
+}
+
+template <typename T>
+BlockList<T>::~BlockList()
+{
+	releaseBlocks();
+}
+
+// Makes room for one more element: a new block once the last one is
+// full, after regrouping into larger blocks if the directory has grown
+// to twice the block size
+template <typename T>
+void BlockList<T>::reserveOne()
+{
+	if (size_ < (directory_.size() << shift_))
+		return;
+	if (directory_.size() >= 2 * blockSize())
+		regroup(shift_ + 1);
+	if (size_ == (directory_.size() << shift_))
+		addBlock();
+}
+
+// The directory slot is taken first, so a failed allocation leaves
+// nothing behind
+template <typename T>
+void BlockList<T>::addBlock()
+{
+	Block block;
+	block.items = NULL;
+	block.head = 0;
+	block.count = 0;
+	directory_.push_back(block);
+	try
+	{
+		directory_.back().items = new T[blockSize()];
+	}
+	catch (...)
+	{
+		directory_.pop_back();
+		throw;
+	}
+}
+
+// Copies the elements, in order, into new blocks of 2^shift slots; the
+// old blocks are only released once every new one is filled
+template <typename T>
+void BlockList<T>::regroup(size_t shift)
+{
+	size_t newSize = static_cast<size_t>(1) << shift;
+	std::vector<Block> regrouped;
+	regrouped.reserve((size_ + newSize - 1) / newSize);
+	try
+	{
+		for (size_t first = 0; first < size_; first += newSize)
+		{
+			Block block;
+			block.items = NULL;
+			block.head = 0;
+			block.count = (size_ - first < newSize) ? size_ - first : newSize;
+			regrouped.push_back(block);
+			regrouped.back().items = new T[newSize];
+			for (size_t k = 0; k < block.count; k++)
+				regrouped.back().items[k] = (*this)[first + k];
+		}
+	}
+	catch (...)
+	{
+		for (size_t b = 0; b < regrouped.size(); b++)
+			delete[] regrouped[b].items;
+		throw;
+	}
+	releaseBlocks();
+	directory_.swap(regrouped);
+	shift_ = shift;
+}
+
+template <typename T>
+void BlockList<T>::releaseBlocks()
+{
+	for (size_t b = 0; b < directory_.size(); b++)
+		delete[] directory_[b].items;
+	directory_.clear();
+}
+
+template <typename T>
+void BlockList<T>::clear()
+{
+	releaseBlocks();
+	size_ = 0;
+	shift_ = minBlockShift;
+}
+
+// Insert into a block that has room, shifting whichever side of `offset`
+// is shorter: the front moves one slot back around the ring, the tail
+// one slot forward
+template <typename T>
+void BlockList<T>::insertIntoBlock(Block& block, size_t offset, const T& value)
+{
+	if (offset < block.count - offset)
+	{
+		block.head = wrap(block.head - 1);
+		for (size_t k = 0; k < offset; k++)
+			block.items[wrap(block.head + k)] = block.items[wrap(block.head + k + 1)];
+	}
+	else
+	{
+		for (size_t k = block.count; k > offset; k--)
+			block.items[wrap(block.head + k)] = block.items[wrap(block.head + k - 1)];
+	}
+	block.items[wrap(block.head + offset)] = value;
+	block.count++;
+}
+
+template <typename T>
+void BlockList<T>::push_back(const T& value)
+{
+	reserveOne();
+	Block& last = directory_.back();
+	last.items[wrap(last.head + last.count)] = value;
+	last.count++;
+	size_++;
+}
+
+// The target block overflows by one element; that element is carried to
+// the front of the next block, whose own last element moves on, and so
+// on. Rotating a full ring by one only moves its head, so each later
+// block costs O(1).
+template <typename T>
+typename BlockList<T>::iterator BlockList<T>::insert(iterator position, const T& value)
+{
+	size_t index = position.index();
+	if (index == size_)
+	{
+		push_back(value);
+		return iterator(this, index);
+	}
+
+	reserveOne();
+
+	size_t target = index >> shift_;
+	size_t last = directory_.size() - 1;
+	if (target == last)
+		insertIntoBlock(directory_[target], wrap(index), value);
+	else
+	{
+		Block& block = directory_[target];
+		T carry = block.items[wrap(block.head + blockSize() - 1)];
+		block.count--;
+		insertIntoBlock(block, wrap(index), value);
+
+		for (size_t b = target + 1; b < last; b++)
+		{
+			Block& full = directory_[b];
+			full.head = wrap(full.head - 1);
+			T displaced = full.items[full.head];
+			full.items[full.head] = carry;
+			carry = displaced;
+		}
+		insertIntoBlock(directory_[last], 0, carry);
+	}
+	size_++;
+	return iterator(this, index);
+}
+
+#endif
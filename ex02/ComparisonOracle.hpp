@@ -0,0 +1,147 @@
+#ifndef COMPARISONORACLE_HPP
+# define COMPARISONORACLE_HPP
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+// Comparison accounting returned by every mergeInsertionSort entry point.
+// Batching is not free in comparator calls: the lockstep searches ask
+// questions ahead of the exact insertion, and some of their answers are
+// never used. comparisons counts every call, speculative ones included,
+// so a batched sort makes more calls than a plain one (about 11% more on
+// random ints); the calls the plain engine would have made are
+// comparisons - speculative + boundaryHits. Nothing is cached by pair of
+// elements: the only reuse is each search's final boundary.
+struct SortStats
+{
+	size_t	comparisons;	// calls made into the user comparator, all of them
+	size_t	speculative;	// of those, asked by lockstep searches (batched only)
+	size_t	boundaryHits;	// exact decisions answered from a lockstep search's boundary
+	size_t	rounds;			// comparator invocations the caller waited for
+	size_t	largestRound;	// most comparisons handed over in one invocation
+	size_t	allocations;	// heap buffers the sort set up (none are made later)
+	size_t	peakBytes;		// bytes those buffers held at once
+
+	// Comparator calls beyond what the plain engine makes; negative when
+	// the boundaries answered more decisions than the lockstep searches cost
+	long extraComparisons() const
+	{
+		return static_cast<long>(speculative) - static_cast<long>(boundaryHits);
+	}
+
+	SortStats() : comparisons(0), speculative(0), boundaryHits(0), rounds(0), largestRound(0), allocations(0), peakBytes(0) {}
+};
+
+// Book a buffer that stays alive until the sort returns
+template <typename T>
+void recordBuffer(SortStats& stats, const std::vector<T>& buffer)
+{
+	if (buffer.capacity() == 0)
+		return;
+	stats.allocations++;
+	stats.peakBytes += buffer.capacity() * sizeof(T);
+}
+
+// The engine never touches keys directly: it asks an oracle whether the
+// element with id `a` orders before the element with id `b`.
+
+// Plain comparator, one call per question
+template <typename RandomIt, typename Compare>
+class PlainOracle
+{
+private:
+	RandomIt	keys_;
+	Compare		comp_;
+	SortStats&	stats_;
+
+	PlainOracle& operator=(const PlainOracle& other);
+
+public:
+	static const bool batched = false;
+
+	PlainOracle(RandomIt keys, Compare comp, SortStats& stats) : keys_(keys), comp_(comp), stats_(stats) {}
+
+	bool less(size_t a, size_t b)
+	{
+		stats_.comparisons++;
+		return comp_(keys_[a], keys_[b]);
+	}
+
+	void lessBatch(const size_t* lhs, const size_t* rhs, size_t count, char* out)
+	{
+		for (size_t i = 0; i < count; i++)
+			out[i] = less(lhs[i], rhs[i]);
+	}
+
+	void reserve(size_t) {}
+
+	void finish()
+	{
+		stats_.rounds = stats_.comparisons;
+		stats_.largestRound = stats_.comparisons > 0 ? 1 : 0;
+	}
+};
+
+// Batch comparator, many independent questions per call. BatchCompare is
+// called as batch(lhs, rhs, count, out) with arrays of element pointers and
+// must set out[i] non-zero when *lhs[i] orders before *rhs[i]; the caller
+// is free to evaluate the count questions in parallel.
+template <typename RandomIt, typename BatchCompare>
+class BatchOracle
+{
+private:
+	typedef typename std::iterator_traits<RandomIt>::value_type Value;
+
+	RandomIt					keys_;
+	BatchCompare				batch_;
+	SortStats&					stats_;
+	std::vector<const Value*>	lhs_;
+	std::vector<const Value*>	rhs_;
+
+	BatchOracle& operator=(const BatchOracle& other);
+
+public:
+	static const bool batched = true;
+
+	BatchOracle(RandomIt keys, BatchCompare batch, SortStats& stats) : keys_(keys), batch_(batch), stats_(stats) {}
+
+	bool less(size_t a, size_t b)
+	{
+		char out;
+		lessBatch(&a, &b, 1, &out);
+		return out != 0;
+	}
+
+	void lessBatch(const size_t* lhs, const size_t* rhs, size_t count, char* out)
+	{
+		if (count == 0)
+			return;
+		lhs_.resize(count);
+		rhs_.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			lhs_[i] = &keys_[lhs[i]];
+			rhs_[i] = &keys_[rhs[i]];
+		}
+		batch_(&lhs_[0], &rhs_[0], count, out);
+
+		stats_.comparisons += count;
+		stats_.rounds++;
+		if (count > stats_.largestRound)
+			stats_.largestRound = count;
+	}
+
+	// Size the pointer arrays for the largest batch up front
+	void reserve(size_t maxBatch)
+	{
+		lhs_.reserve(maxBatch);
+		rhs_.reserve(maxBatch);
+		recordBuffer(stats_, lhs_);
+		recordBuffer(stats_, rhs_);
+	}
+
+	void finish() {}
+};
+
+#endif
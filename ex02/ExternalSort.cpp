@@ -0,0 +1,458 @@
+#include "ExternalSort.hpp"
+#include "ParallelSort.hpp"
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+
+// Orthodox Canonical Form - private constructors
+ExternalSort::ExternalSort() {}
+ExternalSort::ExternalSort(const ExternalSort& other) { (void)other; }
+ExternalSort& ExternalSort::operator=(const ExternalSort& other) { (void)other; return *this; }
+ExternalSort::~ExternalSort() {}
+
+ExternalSort::Config::Config() : memory(0), tempDir("/tmp"), policy(FewestComparisons), jobs(1)
+{
+	const char* dir = std::getenv("TMPDIR");
+	if (dir && *dir)
+		tempDir = dir;
+}
+
+ExternalSort::Report::Report()
+	: elements(0), comparisons(0), runs(0), runLength(0), fanIn(0), passes(0), bytesSpilled(0) {}
+
+// ---------------------------------------------------------------- RunReader
+
+ExternalSort::RunReader::RunReader() : left_(0), failed_(false) {}
+ExternalSort::RunReader::RunReader(const RunReader& other) : left_(0), failed_(other.failed_) {}
+ExternalSort::RunReader& ExternalSort::RunReader::operator=(const RunReader& other) { (void)other; return *this; }
+ExternalSort::RunReader::~RunReader() {}
+
+bool ExternalSort::RunReader::open(int fd, const Run& run, size_t bufferBytes)
+{
+	block_.attachRange(fd, run.offset, run.count * 4, bufferBytes < 4 ? 4 : bufferBytes);
+	left_ = run.count;
+	failed_ = false;
+	return true;
+}
+
+bool ExternalSort::RunReader::next(int& value)
+{
+	if (left_ == 0)
+		return false;
+
+	while (block_.end() - block_.begin() < 4)
+	{
+		if (block_.eof())
+		{
+			// The run is shorter than recorded: the file was damaged
+			failed_ = true;
+			left_ = 0;
+			return false;
+		}
+		block_.refill();
+	}
+
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(block_.data() + block_.begin());
+	value = static_cast<int>(static_cast<unsigned long>(bytes[0])
+		| (static_cast<unsigned long>(bytes[1]) << 8)
+		| (static_cast<unsigned long>(bytes[2]) << 16)
+		| (static_cast<unsigned long>(bytes[3]) << 24));
+	block_.consume(4);
+	left_--;
+	return true;
+}
+
+bool ExternalSort::RunReader::failed() const
+{
+	return failed_;
+}
+
+// ---------------------------------------------------------------- RunWriter
+
+ExternalSort::RunWriter::RunWriter() : fd_(-1), count_(0), runStart_(0), used_(0), failed_(false) {}
+ExternalSort::RunWriter::RunWriter(const RunWriter& other)
+	: fd_(-1), count_(0), runStart_(0), used_(0), failed_(other.failed_) {}
+ExternalSort::RunWriter& ExternalSort::RunWriter::operator=(const RunWriter& other) { (void)other; return *this; }
+
+ExternalSort::RunWriter::~RunWriter()
+{
+	if (fd_ >= 0)
+		close(fd_);
+}
+
+// The file is unlinked right away: it vanishes with its descriptor, even
+// if the process is killed
+bool ExternalSort::RunWriter::open(const std::string& tempDir, size_t bufferBytes)
+{
+	std::string pattern = tempDir + "/PmergeMe.XXXXXX";
+	std::vector<char> path(pattern.begin(), pattern.end());
+	path.push_back('\0');
+
+	fd_ = mkstemp(&path[0]);
+	if (fd_ < 0)
+		return false;
+	unlink(&path[0]);
+
+	buffer_.resize(bufferBytes < 4 ? 4 : bufferBytes - bufferBytes % 4);
+	count_ = 0;
+	runStart_ = 0;
+	used_ = 0;
+	failed_ = false;
+	return true;
+}
+
+void ExternalSort::RunWriter::put(int value)
+{
+	if (used_ + 4 > buffer_.size())
+	{
+		size_t done = 0;
+		while (done < used_ && !failed_)
+		{
+			ssize_t written = write(fd_, &buffer_[done], used_ - done);
+			if (written < 0 && errno == EINTR)
+				continue;
+			if (written <= 0)
+				failed_ = true;
+			else
+				done += written;
+		}
+		used_ = 0;
+	}
+
+	unsigned long bits = static_cast<unsigned long>(value);
+	buffer_[used_] = static_cast<unsigned char>(bits & 0xff);
+	buffer_[used_ + 1] = static_cast<unsigned char>((bits >> 8) & 0xff);
+	buffer_[used_ + 2] = static_cast<unsigned char>((bits >> 16) & 0xff);
+	buffer_[used_ + 3] = static_cast<unsigned char>((bits >> 24) & 0xff);
+	used_ += 4;
+	count_++;
+}
+
+void ExternalSort::RunWriter::endRun(Run& run)
+{
+	run.offset = static_cast<off_t>(runStart_) * 4;
+	run.count = count_ - runStart_;
+	runStart_ = count_;
+}
+
+bool ExternalSort::RunWriter::failed() const
+{
+	return failed_;
+}
+
+bool ExternalSort::RunWriter::finish(int& fd)
+{
+	if (fd_ < 0)
+		return false;
+
+	size_t done = 0;
+	while (done < used_ && !failed_)
+	{
+		ssize_t written = write(fd_, &buffer_[done], used_ - done);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			failed_ = true;
+		else
+			done += written;
+	}
+	used_ = 0;
+
+	fd = fd_;
+	fd_ = -1;
+	return !failed_;
+}
+
+// ---------------------------------------------------------------- LoserTree
+
+ExternalSort::LoserTree::LoserTree(size_t k, size_t& comparisons)
+	: tree_(k), head_(k), live_(k, 0), comparisons_(comparisons) {}
+ExternalSort::LoserTree::LoserTree(const LoserTree& other)
+	: tree_(other.tree_), head_(other.head_), live_(other.live_), comparisons_(other.comparisons_) {}
+ExternalSort::LoserTree& ExternalSort::LoserTree::operator=(const LoserTree& other) { (void)other; return *this; }
+ExternalSort::LoserTree::~LoserTree() {}
+
+// Exhausted sources lose every match; ties go to the earlier run
+bool ExternalSort::LoserTree::beats(size_t a, size_t b)
+{
+	if (!live_[a])
+		return false;
+	if (!live_[b])
+		return true;
+	comparisons_++;
+	if (head_[a] != head_[b])
+		return head_[a] < head_[b];
+	return a < b;
+}
+
+// Leaves k..2k-1 stand for sources 0..k-1; returns the winner below node
+size_t ExternalSort::LoserTree::build(size_t node)
+{
+	size_t k = tree_.size();
+	if (node >= k)
+		return node - k;
+
+	size_t left = build(2 * node);
+	size_t right = build(2 * node + 1);
+	if (beats(left, right))
+	{
+		tree_[node] = right;
+		return left;
+	}
+	tree_[node] = left;
+	return right;
+}
+
+void ExternalSort::LoserTree::set(size_t source, bool live, int value)
+{
+	live_[source] = live;
+	head_[source] = value;
+}
+
+void ExternalSort::LoserTree::start()
+{
+	tree_[0] = (tree_.size() == 1) ? 0 : build(1);
+}
+
+bool ExternalSort::LoserTree::empty() const
+{
+	return !live_[tree_[0]];
+}
+
+size_t ExternalSort::LoserTree::winner() const
+{
+	return tree_[0];
+}
+
+int ExternalSort::LoserTree::top() const
+{
+	return head_[tree_[0]];
+}
+
+void ExternalSort::LoserTree::replay(size_t source)
+{
+	size_t winner = source;
+	for (size_t node = (source + tree_.size()) / 2; node > 0; node /= 2)
+	{
+		if (beats(tree_[node], winner))
+		{
+			size_t loser = winner;
+			winner = tree_[node];
+			tree_[node] = loser;
+		}
+	}
+	tree_[0] = winner;
+}
+
+// ---------------------------------------------------------------- ExternalSort
+
+// A sixteenth of the budget, within sequential-I/O limits
+size_t ExternalSort::ioBufferBytes(size_t memory)
+{
+	size_t bytes = memory / 16;
+	if (bytes < minIoBuffer)
+		bytes = minIoBuffer;
+	if (bytes > maxIoBuffer)
+		bytes = maxIoBuffer;
+	return bytes;
+}
+
+// Values per run: what the budget leaves after the three I/O buffers,
+// divided by the run itself plus what the in-memory sort needs on top of
+// it (see SortStats::peakBytes: about 15 words per element for
+// merge-insertion, 2 for the fast policy, 2 more for the merge buffers
+// of the threaded sort), with a word of slack
+size_t ExternalSort::runCapacity(const Config& config)
+{
+	size_t overhead = (config.policy == FastestWallClock) ? 3 : 16;
+	if (config.jobs > 1)
+		overhead += 2;
+	size_t perElement = sizeof(int) + overhead * sizeof(size_t);
+	size_t reserved = 3 * ioBufferBytes(config.memory);
+	size_t capacity = (config.memory > reserved) ? (config.memory - reserved) / perElement : 0;
+	return capacity > 0 ? capacity : 1;
+}
+
+// Widest merge the budget allows, each input and the output moving at
+// least minMergeBlock at a time; then the narrowest merge that needs no
+// more passes than that, so every block is as large as it can be
+size_t ExternalSort::mergeFanIn(size_t runs, size_t memory)
+{
+	size_t widest = memory / minMergeBlock - 1;
+	if (widest > maxFanIn)
+		widest = maxFanIn;
+	if (widest < 2)
+		widest = 2;
+	if (runs <= widest)
+		return runs;
+
+	size_t passes = mergePasses(runs, widest);
+	size_t fanIn = 2;
+	while (mergePasses(runs, fanIn) > passes)
+		fanIn++;
+	return fanIn;
+}
+
+// Passes a fanIn-way merge makes over `runs` runs, the final one included
+size_t ExternalSort::mergePasses(size_t runs, size_t fanIn)
+{
+	size_t passes = 1;
+	while (runs > fanIn)
+	{
+		runs = (runs + fanIn - 1) / fanIn;
+		passes++;
+	}
+	return passes;
+}
+
+// Every run goes to the same file, one after the other
+bool ExternalSort::spillRuns(NumberReader& source, const Config& config, ValueSink& before,
+	int& fd, std::vector<Run>& runs, Report& report)
+{
+	size_t capacity = runCapacity(config);
+	std::vector<int> chunk;
+	chunk.reserve(capacity);
+
+	RunWriter writer;
+	if (!writer.open(config.tempDir, ioBufferBytes(config.memory)))
+		return false;
+
+	while (true)
+	{
+		chunk.clear();
+		if (!source.read(chunk, capacity))
+			return false;
+		if (chunk.empty())
+			break;
+
+		for (size_t i = 0; i < chunk.size(); i++)
+			before.put(chunk[i]);
+		report.elements += chunk.size();
+		if (chunk.size() > report.runLength)
+			report.runLength = chunk.size();
+		report.comparisons += mergeInsertionSortParallel(chunk, std::less<int>(), config.policy,
+			config.jobs).comparisons;
+
+		Run run;
+		for (size_t i = 0; i < chunk.size(); i++)
+			writer.put(chunk[i]);
+		writer.endRun(run);
+		if (writer.failed())
+			return false;
+		runs.push_back(run);
+		report.bytesSpilled += run.count * 4;
+	}
+
+	if (!writer.finish(fd))
+	{
+		close(fd);
+		fd = -1;
+		return false;
+	}
+	before.end();
+	return true;
+}
+
+// Exactly one of sink and writer receives the merged values
+bool ExternalSort::mergeRuns(int fd, const Run* runs, size_t k, size_t bufferBytes, ValueSink* sink,
+	RunWriter* writer, size_t& comparisons)
+{
+	RunReader readers[maxFanIn];
+	LoserTree tree(k, comparisons);
+
+	for (size_t i = 0; i < k; i++)
+	{
+		int value = 0;
+		readers[i].open(fd, runs[i], bufferBytes);
+		bool live = readers[i].next(value);
+		tree.set(i, live, value);
+	}
+	tree.start();
+
+	while (!tree.empty())
+	{
+		size_t source = tree.winner();
+		if (sink)
+			sink->put(tree.top());
+		else
+			writer->put(tree.top());
+
+		int value = 0;
+		bool live = readers[source].next(value);
+		tree.set(source, live, value);
+		tree.replay(source);
+	}
+
+	for (size_t i = 0; i < k; i++)
+	{
+		if (readers[i].failed())
+			return false;
+	}
+	return true;
+}
+
+bool ExternalSort::sort(NumberReader& source, const Config& config, ValueSink& before, ValueSink& after,
+	Report& report)
+{
+	int fd = -1;
+	std::vector<Run> runs;
+	bool spilled = spillRuns(source, config, before, fd, runs, report);
+	if (!spilled)
+		before.abort();
+	if (!spilled || runs.empty())
+	{
+		if (fd >= 0)
+			close(fd);
+		return false;
+	}
+	report.runs = runs.size();
+
+	// Every merge input and the output get an equal share of what the
+	// caller's reader and output buffer leave
+	size_t memory = config.memory - 2 * ioBufferBytes(config.memory);
+	size_t fanIn = mergeFanIn(runs.size(), memory);
+	report.fanIn = fanIn;
+	size_t bufferBytes = memory / (fanIn + 1);
+
+	// Intermediate passes until one merge can take every run; each pass
+	// reads one file and writes the next
+	while (runs.size() > fanIn)
+	{
+		std::vector<Run> merged;
+		RunWriter writer;
+		bool ok = writer.open(config.tempDir, bufferBytes);
+		for (size_t first = 0; ok && first < runs.size(); first += fanIn)
+		{
+			size_t last = (first + fanIn < runs.size()) ? first + fanIn : runs.size();
+			ok = mergeRuns(fd, &runs[first], last - first, bufferBytes, NULL, &writer, report.comparisons)
+				&& !writer.failed();
+
+			Run run;
+			writer.endRun(run);
+			merged.push_back(run);
+			report.bytesSpilled += run.count * 4;
+		}
+
+		int next = -1;
+		ok = writer.finish(next) && ok;
+		close(fd);
+		fd = next;
+		if (!ok)
+		{
+			if (fd >= 0)
+				close(fd);
+			return false;
+		}
+		runs.swap(merged);
+		report.passes++;
+	}
+
+	bool ok = mergeRuns(fd, &runs[0], runs.size(), bufferBytes, &after, NULL, report.comparisons);
+	report.passes++;
+	close(fd);
+	if (ok)
+		after.end();
+	else
+		after.abort();
+	return ok;
+}
@@ -0,0 +1,173 @@
+#ifndef EXTERNALSORT_HPP
+# define EXTERNALSORT_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <sys/types.h>
+#include "HybridSort.hpp"
+#include "NumberReader.hpp"
+#include "BlockReader.hpp"
+
+// External-memory sort for inputs larger than RAM.
+// Phase 1 reads as many values as fit in the memory budget, sorts them
+// with the in-memory merge-insertion engine and appends them as a run to
+// one unlinked temporary file. Phase 2 merges up to fanIn runs at a time
+// through a loser tree, each run read and the output written in large
+// sequential blocks; if there are more runs than that, intermediate
+// passes merge them into longer runs, written to a new file, first.
+// A run is an extent of its file, read with pread(2), so the sort holds
+// at most two descriptors however many runs there are.
+// Runs are packed 32-bit little-endian ints, the same as --binary input.
+class ExternalSort
+{
+public:
+	// Receives a stream of values; end() follows the last one, or abort()
+	// if the sort failed part way through the stream
+	class ValueSink
+	{
+	public:
+		virtual ~ValueSink() {}
+		virtual void put(int value) = 0;
+		virtual void end() = 0;
+		virtual void abort() = 0;
+	};
+
+	struct Config
+	{
+		size_t		memory;		// bytes for everything: I/O buffers, runs, merge buffers
+		std::string	tempDir;
+		SortPolicy	policy;
+		size_t		jobs;
+
+		Config();
+	};
+
+	struct Report
+	{
+		size_t	elements;
+		size_t	comparisons;
+		size_t	runs;			// runs written by phase 1
+		size_t	runLength;		// elements in the longest run
+		size_t	fanIn;			// runs merged at once
+		size_t	passes;			// merge passes, the final one included
+		size_t	bytesSpilled;	// run data written to temporary files
+
+		Report();
+	};
+
+	// Smallest budget accepted: a few merge blocks
+	static const size_t minMemory = 1 << 18;
+
+	// Size of each block buffer the sort's I/O uses: the caller's input
+	// reader and output buffer, and the writer spilling a run. The budget
+	// counts three of them.
+	static size_t ioBufferBytes(size_t memory);
+
+	// Values read from `source` go to `before` in input order, the sorted
+	// result to `after`. Fails on invalid or empty input and on I/O errors.
+	static bool sort(NumberReader& source, const Config& config, ValueSink& before, ValueSink& after,
+		Report& report);
+
+private:
+	// Orthodox Canonical Form - private constructors since this is a utility class
+	ExternalSort();
+	ExternalSort(const ExternalSort& other);
+	ExternalSort& operator=(const ExternalSort& other);
+	~ExternalSort();
+
+	// Smallest read block per merge input; small budgets trade block size
+	// for fan-in rather than fall back to many binary merge passes
+	static const size_t minMergeBlock = 1 << 12;
+	static const size_t minIoBuffer = 1 << 12;
+	static const size_t maxIoBuffer = 1 << 20;
+	static const size_t maxFanIn = 256;
+
+	// One spilled run: where it starts in its file, and its length
+	struct Run
+	{
+		off_t	offset;		// in bytes
+		size_t	count;
+	};
+
+	// Buffered, sequential reader over one run
+	class RunReader
+	{
+	private:
+		BlockReader	block_;
+		size_t		left_;		// values not yet handed out
+		bool		failed_;
+
+		RunReader(const RunReader& other);
+		RunReader& operator=(const RunReader& other);
+
+	public:
+		RunReader();
+		~RunReader();
+		bool open(int fd, const Run& run, size_t bufferBytes);
+		bool next(int& value);	// false once the run is exhausted
+		bool failed() const;
+	};
+
+	// Buffered writer appending runs to a new temporary file
+	class RunWriter
+	{
+	private:
+		int							fd_;
+		size_t						count_;		// values written so far
+		size_t						runStart_;	// value the current run starts at
+		std::vector<unsigned char>	buffer_;
+		size_t						used_;
+		bool						failed_;
+
+		RunWriter(const RunWriter& other);
+		RunWriter& operator=(const RunWriter& other);
+
+	public:
+		RunWriter();
+		~RunWriter();
+		bool open(const std::string& tempDir, size_t bufferBytes);
+		void put(int value);
+		void endRun(Run& run);	// the values put since the last run
+		bool failed() const;
+		bool finish(int& fd);	// flushes and hands over the descriptor
+	};
+
+	// Tournament of losers over k sources: tree_[0] is the current
+	// winner, tree_[1..k-1] the loser of each internal match. Replacing
+	// the winner replays only the matches on its path to the root.
+	class LoserTree
+	{
+	private:
+		std::vector<size_t>	tree_;
+		std::vector<int>	head_;		// current value of each source
+		std::vector<char>	live_;		// source not yet exhausted
+		size_t&				comparisons_;
+
+		LoserTree(const LoserTree& other);
+		LoserTree& operator=(const LoserTree& other);
+
+		bool beats(size_t a, size_t b);
+		size_t build(size_t node);
+
+	public:
+		LoserTree(size_t k, size_t& comparisons);
+		~LoserTree();
+		void set(size_t source, bool live, int value);
+		void start();
+		bool empty() const;
+		size_t winner() const;
+		int top() const;
+		void replay(size_t source);
+	};
+
+	static size_t runCapacity(const Config& config);
+	static size_t mergeFanIn(size_t runs, size_t memory);
+	static size_t mergePasses(size_t runs, size_t fanIn);
+	static bool spillRuns(NumberReader& source, const Config& config, ValueSink& before,
+		int& fd, std::vector<Run>& runs, Report& report);
+	static bool mergeRuns(int fd, const Run* runs, size_t k, size_t bufferBytes, ValueSink* sink,
+		RunWriter* writer, size_t& comparisons);
+};
+
+#endif
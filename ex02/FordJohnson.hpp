@@ -0,0 +1,159 @@
+#ifndef FORDJOHNSON_HPP
+# define FORDJOHNSON_HPP
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include "InsertionChain.hpp"
+#include "ComparisonOracle.hpp"
+#include "HybridSort.hpp"
+
+// Index-based Ford-Johnson (merge-insertion) sort.
+// Works on item ids instead of values: the result is the permutation that
+// sorts the keys, so callers can reorder records of any size afterwards
+// without the sort ever copying a payload.
+//
+// Every recursion level keeps a pair-link table (big[p], small[p]) so that
+// after the bigs are sorted each small is inserted with its search bounded
+// by its own partner, in Jacobsthal order. All per-level arrays are carved
+// out of one workspace allocated up front and released in stack order.
+//
+// Comparisons go through an Oracle (see ComparisonOracle.hpp). With a
+// batched oracle each level's pairing is one batch, and each Jacobsthal
+// group is first searched in lockstep against the chain as it stood when
+// the group started (one batch per search step). Each search keeps only
+// its result, a boundary per element, so the exact insertion that follows
+// makes the same decisions as the unbatched engine and only calls the
+// comparator again for elements inserted within the same group. This is
+// not a memo of comparison results: the lockstep questions are
+// speculative and cost comparator calls of their own, so the batched mode
+// makes more calls in total than the plain engine (about 11% on random
+// ints) in exchange for far fewer rounds.
+template <typename Oracle>
+class FordJohnson
+{
+private:
+	static const size_t npos = static_cast<size_t>(-1);
+
+	// Levels this small use SmallChain instead of the tree
+	static const size_t smallLevelSize = 16;
+
+	Oracle&					oracle_;
+	SortStats&				stats_;
+	std::vector<size_t>		workspace_;
+	size_t					top_;
+	InsertionChain<size_t>	chain_;
+
+	// Lockstep search state, only used by batched oracles
+	std::vector<size_t>		lo_;
+	std::vector<size_t>		hi_;
+	std::vector<size_t>		slot_;
+	std::vector<size_t>		lhs_;
+	std::vector<size_t>		rhs_;
+	std::vector<char>		answers_;
+
+	FordJohnson(Oracle& oracle, SortStats& stats, size_t n);
+	FordJohnson(const FordJohnson& other);
+	FordJohnson& operator=(const FordJohnson& other);
+	~FordJohnson();
+
+	// Orders chain items against the item being inserted
+	struct ItemBefore
+	{
+		FordJohnson&	engine;
+		const size_t*	rep;
+		size_t			item;
+		ItemBefore(FordJohnson& e, const size_t* r, size_t i) : engine(e), rep(r), item(i) {}
+		bool operator()(size_t other, size_t, size_t) const
+		{
+			return engine.less(repOf(rep, other), repOf(rep, item));
+		}
+	};
+
+	// Same ordering, but elements that were already in the chain when the
+	// group started are answered from the lockstep search's boundary
+	struct KnownOrBefore
+	{
+		FordJohnson&	engine;
+		const size_t*	rep;
+		size_t			item;
+		size_t			groupMark;
+		size_t			boundaryRank;
+		KnownOrBefore(FordJohnson& e, const size_t* r, size_t i, size_t m, size_t b)
+			: engine(e), rep(r), item(i), groupMark(m), boundaryRank(b) {}
+		bool operator()(size_t other, size_t rank, size_t handle) const
+		{
+			if (handle < groupMark)
+			{
+				engine.stats_.boundaryHits++;
+				return rank < boundaryRank;
+			}
+			return engine.less(repOf(rep, other), repOf(rep, item));
+		}
+	};
+
+	static size_t repOf(const size_t* rep, size_t item) { return rep ? rep[item] : item; }
+	bool less(size_t a, size_t b) { return oracle_.less(a, b); }
+
+	size_t* acquire(size_t count);
+	void pairUp(const size_t* rep, size_t m, size_t* big, size_t* small);
+	template <typename Chain>
+	void insertGroup(Chain& chain, const size_t* rep, const size_t* items, const size_t* bounds, size_t count);
+	template <typename Chain>
+	void insertGroupBatched(Chain& chain, const size_t* rep, const size_t* items, const size_t* bounds, size_t count);
+	template <typename Chain>
+	void insertPending(Chain& chain, const size_t* rep, size_t n, const size_t* small, const size_t* big,
+		const size_t* pairOrder, size_t* handle, size_t* items, size_t* bounds, size_t* out);
+	void sortLevel(const size_t* rep, size_t n, size_t* out);
+
+public:
+	// Words of workspace needed for n items (about 7n)
+	static size_t workspaceSize(size_t n);
+
+	// order[i] is the id of the i-th smallest element known to the oracle
+	static void sortPermutation(Oracle& oracle, size_t n, SortStats& stats, std::vector<size_t>& order);
+};
+
+// Storage categories picked at compile time by ContainerTraits
+struct ContiguousStorageTag {};
+struct SegmentedStorageTag {};
+
+// Anything not known to be contiguous is treated as deque-like and its
+// keys are read through its iterator; vectors are read through a pointer
+template <typename Container>
+struct ContainerTraits
+{
+	typedef SegmentedStorageTag category;
+};
+
+template <typename T, typename Alloc>
+struct ContainerTraits<std::vector<T, Alloc> >
+{
+	typedef ContiguousStorageTag category;
+};
+
+// Library entry points. Each sorts a whole container with the
+// comparison-minimal merge-insertion and reports what it asked for and
+// the memory it set up. All buffers are sized once before sorting starts;
+// the container is then permuted in place.
+template <typename Container>
+SortStats mergeInsertionSort(Container& c);
+
+template <typename Container, typename Compare>
+SortStats mergeInsertionSort(Container& c, Compare comp);
+
+// FastestWallClock gives up comparison-optimality for speed at large n
+template <typename Container, typename Compare>
+SortStats mergeInsertionSort(Container& c, Compare comp, SortPolicy policy);
+
+// BatchCompare: see BatchOracle in ComparisonOracle.hpp. Fewer rounds,
+// but more comparator calls than mergeInsertionSort (about 11% more on
+// random ints); stats.speculative and stats.extraComparisons() say how many.
+template <typename Container, typename BatchCompare>
+SortStats mergeInsertionSortBatched(Container& c, BatchCompare batch);
+
+#include "FordJohnson.tpp"
+
+#endif
@@ -0,0 +1,369 @@
+#ifndef FORDJOHNSON_TPP
+# define FORDJOHNSON_TPP
+
+template <typename Oracle>
+FordJohnson<Oracle>::FordJohnson(Oracle& oracle, SortStats& stats, size_t n)
+	: oracle_(oracle), stats_(stats), workspace_(workspaceSize(n)), top_(0)
+{
+	chain_.reserve(n);
+	recordBuffer(stats_, workspace_);
+	stats_.allocations += 2;	// the chain's sentinel, then its reserve
+	stats_.peakBytes += chain_.capacityBytes();
+
+	// The largest batch is one level's pairing or one group: at most n/2 + 1
+	if (Oracle::batched)
+	{
+		size_t maxBatch = n / 2 + 1;
+		lo_.reserve(maxBatch);
+		hi_.reserve(maxBatch);
+		slot_.reserve(maxBatch);
+		lhs_.reserve(maxBatch);
+		rhs_.reserve(maxBatch);
+		answers_.reserve(maxBatch);
+		recordBuffer(stats_, lo_);
+		recordBuffer(stats_, hi_);
+		recordBuffer(stats_, slot_);
+		recordBuffer(stats_, lhs_);
+		recordBuffer(stats_, rhs_);
+		recordBuffer(stats_, answers_);
+		oracle_.reserve(maxBatch);
+	}
+}
+
+// Orthodox Canonical Form - the engine only lives for one sort
+template <typename Oracle>
+FordJohnson<Oracle>::FordJohnson(const FordJohnson& other)
+	: oracle_(other.oracle_), stats_(other.stats_), workspace_(other.workspace_), top_(other.top_), chain_(other.chain_) {}
+template <typename Oracle>
+FordJohnson<Oracle>& FordJohnson<Oracle>::operator=(const FordJohnson& other) { (void)other; return *this; }
+template <typename Oracle>
+FordJohnson<Oracle>::~FordJohnson() {}
+
+template <typename Oracle>
+size_t FordJohnson<Oracle>::workspaceSize(size_t n)
+{
+	// big, small, nextRep, pairOrder and handle arrays for every level,
+	// plus the pending items and their bounds (one more for the straggler)
+	size_t total = 0;
+	for (size_t m = n / 2; m > 0; m /= 2)
+		total += 7 * m + 2;
+	return total;
+}
+
+// Bump allocation; callers restore top_ when their level returns
+template <typename Oracle>
+size_t* FordJohnson<Oracle>::acquire(size_t count)
+{
+	size_t* block = &workspace_[0] + top_;
+	top_ += count;
+	return block;
+}
+
+// Pair adjacent items and record the pair links
+template <typename Oracle>
+void FordJohnson<Oracle>::pairUp(const size_t* rep, size_t m, size_t* big, size_t* small)
+{
+	if (Oracle::batched)
+	{
+		// All m comparisons are independent: ask them in one batch
+		lhs_.resize(m);
+		rhs_.resize(m);
+		answers_.resize(m);
+		for (size_t p = 0; p < m; p++)
+		{
+			lhs_[p] = repOf(rep, 2 * p + 1);
+			rhs_[p] = repOf(rep, 2 * p);
+		}
+		oracle_.lessBatch(&lhs_[0], &rhs_[0], m, &answers_[0]);
+	}
+
+	for (size_t p = 0; p < m; p++)
+	{
+		size_t x = 2 * p;
+		size_t y = 2 * p + 1;
+		bool swapped = Oracle::batched ? answers_[p] != 0 : less(repOf(rep, y), repOf(rep, x));
+		big[p] = swapped ? x : y;
+		small[p] = swapped ? y : x;
+	}
+}
+
+// Insert one Jacobsthal group, from its top down. bounds[j] is the chain
+// handle of items[j]'s partner (npos for the straggler): the search for a
+// small only covers the chain up to its partner's current rank.
+template <typename Oracle>
+template <typename Chain>
+void FordJohnson<Oracle>::insertGroup(Chain& chain, const size_t* rep, const size_t* items, const size_t* bounds, size_t count)
+{
+	for (size_t j = count; j-- > 0; )
+	{
+		size_t limit = (bounds[j] == npos) ? chain.size() : chain.rankOf(bounds[j]);
+		size_t rank = chain.partitionPoint(limit, ItemBefore(*this, rep, items[j]));
+		chain.insertAt(rank, items[j]);
+	}
+}
+
+template <typename Oracle>
+template <typename Chain>
+void FordJohnson<Oracle>::insertGroupBatched(Chain& chain, const size_t* rep, const size_t* items, const size_t* bounds, size_t count)
+{
+	// Phase 1: every member binary-searches the chain as it stands now,
+	// one batch per search step
+	lo_.assign(count, 0);
+	hi_.resize(count);
+	for (size_t j = 0; j < count; j++)
+		hi_[j] = (bounds[j] == npos) ? chain.size() : chain.rankOf(bounds[j]);
+
+	while (true)
+	{
+		size_t active = 0;
+		slot_.resize(count);
+		lhs_.resize(count);
+		rhs_.resize(count);
+		for (size_t j = 0; j < count; j++)
+		{
+			if (lo_[j] >= hi_[j])
+				continue;
+			size_t mid = lo_[j] + (hi_[j] - lo_[j]) / 2;
+			slot_[active] = j;
+			lhs_[active] = repOf(rep, chain.at(mid));
+			rhs_[active] = repOf(rep, items[j]);
+			active++;
+		}
+		if (active == 0)
+			break;
+
+		answers_.resize(active);
+		oracle_.lessBatch(&lhs_[0], &rhs_[0], active, &answers_[0]);
+		stats_.speculative += active;
+		for (size_t a = 0; a < active; a++)
+		{
+			size_t j = slot_[a];
+			size_t mid = lo_[j] + (hi_[j] - lo_[j]) / 2;
+			if (answers_[a])
+				lo_[j] = mid + 1;
+			else
+				hi_[j] = mid;
+		}
+	}
+
+	// Remember each member's first element not before it as a handle;
+	// handles keep their relative order while the group is inserted
+	for (size_t j = 0; j < count; j++)
+		lo_[j] = (lo_[j] < chain.size()) ? chain.handleAt(lo_[j]) : npos;
+
+	// Phase 2: the exact insertion, with old elements answered from the
+	// boundaries
+	size_t groupMark = chain.mark();
+	for (size_t j = count; j-- > 0; )
+	{
+		size_t limit = (bounds[j] == npos) ? chain.size() : chain.rankOf(bounds[j]);
+		size_t boundaryRank = (lo_[j] == npos) ? npos : chain.rankOf(lo_[j]);
+		size_t rank = chain.partitionPoint(limit, KnownOrBefore(*this, rep, items[j], groupMark, boundaryRank));
+		chain.insertAt(rank, items[j]);
+	}
+}
+
+// Sorts items 0..n-1 of one level, where item i is represented by element
+// rep[i] (identity when rep is NULL). Writes the sorted item ids to out.
+template <typename Oracle>
+void FordJohnson<Oracle>::sortLevel(const size_t* rep, size_t n, size_t* out)
+{
+	if (n == 0)
+		return;
+	if (n == 1)
+	{
+		out[0] = 0;
+		return;
+	}
+
+	size_t mark = top_;
+	size_t m = n / 2;
+	size_t* big = acquire(m);
+	size_t* small = acquire(m);
+	size_t* nextRep = acquire(m);
+	size_t* pairOrder = acquire(m);
+	size_t* handle = acquire(m);
+	size_t* items = acquire(m + 1);
+	size_t* bounds = acquire(m + 1);
+
+	// Step 1: Pair adjacent items and record the pair links
+	pairUp(rep, m, big, small);
+	for (size_t p = 0; p < m; p++)
+		nextRep[p] = repOf(rep, big[p]);
+
+	// Step 2: Recursively sort the pairs by their big element
+	sortLevel(nextRep, m, pairOrder);
+
+	// Steps 3-4 on the last few levels skip the tree entirely
+	if (n <= smallLevelSize)
+	{
+		SmallChain<size_t, smallLevelSize> chain;
+		insertPending(chain, rep, n, small, big, pairOrder, handle, items, bounds, out);
+	}
+	else
+		insertPending(chain_, rep, n, small, big, pairOrder, handle, items, bounds, out);
+	top_ = mark;
+}
+
+// Build the main chain from the sorted pairs and insert the pending
+// elements; writes the sorted item ids of the level to out
+template <typename Oracle>
+template <typename Chain>
+void FordJohnson<Oracle>::insertPending(Chain& chain, const size_t* rep, size_t n, const size_t* small,
+	const size_t* big, const size_t* pairOrder, size_t* handle, size_t* items, size_t* bounds, size_t* out)
+{
+	size_t m = n / 2;
+
+	// Step 3: Main chain = partner of the smallest big, then all bigs
+	chain.clear();
+	chain.insertAt(0, small[pairOrder[0]]);
+	for (size_t k = 0; k < m; k++)
+		handle[k] = chain.insertAt(k + 1, big[pairOrder[k]]);
+
+	// Step 4: Insert the remaining smalls (and the straggler, as pend
+	// element m) in Jacobsthal groups, each group from its top down.
+	// A small is only searched up to its own partner's current rank.
+	size_t pendEnd = m + (n % 2);
+	size_t done = 1;
+	size_t prevJacobsthal = 1;
+	size_t jacobsthal = 3;
+	while (done < pendEnd)
+	{
+		size_t groupEnd = jacobsthal < pendEnd ? jacobsthal : pendEnd;
+		size_t count = groupEnd - done;
+		for (size_t j = 0; j < count; j++)
+		{
+			size_t k = done + j;
+			items[j] = (k < m) ? small[pairOrder[k]] : n - 1;
+			bounds[j] = (k < m) ? handle[k] : npos;
+		}
+		if (Oracle::batched)
+			insertGroupBatched(chain, rep, items, bounds, count);
+		else
+			insertGroup(chain, rep, items, bounds, count);
+		done = groupEnd;
+		size_t next = jacobsthal + 2 * prevJacobsthal;
+		prevJacobsthal = jacobsthal;
+		jacobsthal = next;
+	}
+
+	chain.copyTo(out);
+}
+
+template <typename Oracle>
+void FordJohnson<Oracle>::sortPermutation(Oracle& oracle, size_t n, SortStats& stats, std::vector<size_t>& order)
+{
+	order.resize(n);
+	if (n == 0)
+		return;
+	recordBuffer(stats, order);
+
+	FordJohnson engine(oracle, stats, n);
+	engine.sortLevel(NULL, n, &order[0]);
+	oracle.finish();
+}
+
+// Raw pointer for contiguous storage, the container iterator otherwise
+template <typename Container>
+const typename Container::value_type* keyAccess(const Container& c, ContiguousStorageTag)
+{
+	return &c[0];
+}
+
+template <typename Container>
+typename Container::const_iterator keyAccess(const Container& c, SegmentedStorageTag)
+{
+	return c.begin();
+}
+
+// Moves every element straight to its sorted position, one cycle of the
+// permutation at a time: no gather buffer, one temporary per cycle.
+// order is consumed (left as the identity).
+template <typename Container>
+void applyPermutation(Container& c, std::vector<size_t>& order)
+{
+	typedef typename Container::value_type Value;
+
+	for (size_t start = 0; start < order.size(); start++)
+	{
+		if (order[start] == start)
+			continue;
+
+		Value carried = c[start];
+		size_t slot = start;
+		while (order[slot] != start)
+		{
+			size_t from = order[slot];
+			c[slot] = c[from];
+			order[slot] = slot;
+			slot = from;
+		}
+		c[slot] = carried;
+		order[slot] = slot;
+	}
+}
+
+template <typename RandomIt, typename Compare>
+void sortKeys(RandomIt keys, size_t n, Compare comp, SortPolicy policy, SortStats& stats, std::vector<size_t>& order)
+{
+	typedef PlainOracle<RandomIt, Compare> Oracle;
+
+	Oracle oracle(keys, comp, stats);
+	if (policy == FastestWallClock)
+		mergeSortPermutation(oracle, n, stats, order);
+	else
+		FordJohnson<Oracle>::sortPermutation(oracle, n, stats, order);
+}
+
+template <typename RandomIt, typename BatchCompare>
+void sortKeysBatched(RandomIt keys, size_t n, BatchCompare batch, SortStats& stats, std::vector<size_t>& order)
+{
+	typedef BatchOracle<RandomIt, BatchCompare> Oracle;
+
+	Oracle oracle(keys, batch, stats);
+	FordJohnson<Oracle>::sortPermutation(oracle, n, stats, order);
+}
+
+template <typename Container, typename Compare>
+SortStats mergeInsertionSort(Container& c, Compare comp, SortPolicy policy)
+{
+	typedef typename ContainerTraits<Container>::category Category;
+
+	SortStats stats;
+	if (c.size() <= 1)
+		return stats;
+
+	std::vector<size_t> order;
+	sortKeys(keyAccess(c, Category()), c.size(), comp, policy, stats, order);
+	applyPermutation(c, order);
+	return stats;
+}
+
+template <typename Container, typename Compare>
+SortStats mergeInsertionSort(Container& c, Compare comp)
+{
+	return mergeInsertionSort(c, comp, FewestComparisons);
+}
+
+template <typename Container>
+SortStats mergeInsertionSort(Container& c)
+{
+	return mergeInsertionSort(c, std::less<typename Container::value_type>());
+}
+
+template <typename Container, typename BatchCompare>
+SortStats mergeInsertionSortBatched(Container& c, BatchCompare batch)
+{
+	typedef typename ContainerTraits<Container>::category Category;
+
+	SortStats stats;
+	if (c.size() <= 1)
+		return stats;
+
+	std::vector<size_t> order;
+	sortKeysBatched(keyAccess(c, Category()), c.size(), batch, stats, order);
+	applyPermutation(c, order);
+	return stats;
+}
+
+#endif
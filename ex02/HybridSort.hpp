@@ -0,0 +1,31 @@
+#ifndef HYBRIDSORT_HPP
+# define HYBRIDSORT_HPP
+
+#include <vector>
+#include <cstddef>
+#include "ComparisonOracle.hpp"
+
+// What mergeInsertionSort optimizes for
+enum SortPolicy
+{
+	FewestComparisons,	// Ford-Johnson all the way down (the default)
+	FastestWallClock	// sorting networks on small blocks, then bottom-up merges
+};
+
+// Block size the wall-clock policy hands to the sorting network
+static const size_t networkBlockSize = 16;
+
+// Batcher odd-even merge network on ids[0..n), n <= networkBlockSize.
+// Every comparator is a compare-exchange without data-dependent branches
+// on the ids, so it compiles to conditional moves.
+template <typename Oracle>
+void networkSort(Oracle& oracle, size_t* ids, size_t n);
+
+// Wall-clock policy: network-sorted blocks merged pairwise with two
+// ping-pong buffers, each pass a sequential sweep over memory
+template <typename Oracle>
+void mergeSortPermutation(Oracle& oracle, size_t n, SortStats& stats, std::vector<size_t>& order);
+
+#include "HybridSort.tpp"
+
+#endif
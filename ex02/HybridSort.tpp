@@ -0,0 +1,73 @@
+#ifndef HYBRIDSORT_TPP
+# define HYBRIDSORT_TPP
+
+template <typename Oracle>
+void networkSort(Oracle& oracle, size_t* ids, size_t n)
+{
+	for (size_t p = 1; p < n; p <<= 1)
+	{
+		for (size_t k = p; k >= 1; k >>= 1)
+		{
+			for (size_t j = k % p; j + k < n; j += 2 * k)
+			{
+				for (size_t i = 0; i < k && i + j + k < n; i++)
+				{
+					// Only compare within the same 2p-sized merge
+					if ((i + j) / (2 * p) != (i + j + k) / (2 * p))
+						continue;
+					size_t a = ids[i + j];
+					size_t b = ids[i + j + k];
+					bool swapped = oracle.less(b, a);
+					ids[i + j] = swapped ? b : a;
+					ids[i + j + k] = swapped ? a : b;
+				}
+			}
+		}
+	}
+}
+
+template <typename Oracle>
+void mergeSortPermutation(Oracle& oracle, size_t n, SortStats& stats, std::vector<size_t>& order)
+{
+	order.resize(n);
+	for (size_t i = 0; i < n; i++)
+		order[i] = i;
+	recordBuffer(stats, order);
+
+	for (size_t start = 0; start < n; start += networkBlockSize)
+	{
+		size_t length = (n - start < networkBlockSize) ? n - start : networkBlockSize;
+		networkSort(oracle, &order[start], length);
+	}
+
+	std::vector<size_t> buffer(n);
+	recordBuffer(stats, buffer);
+	for (size_t width = networkBlockSize; width < n; width *= 2)
+	{
+		for (size_t start = 0; start < n; start += 2 * width)
+		{
+			size_t mid = (start + width < n) ? start + width : n;
+			size_t end = (start + 2 * width < n) ? start + 2 * width : n;
+			size_t left = start;
+			size_t right = mid;
+			size_t dst = start;
+
+			// Take from the right run only when strictly smaller (stable)
+			while (left < mid && right < end)
+			{
+				if (oracle.less(order[right], order[left]))
+					buffer[dst++] = order[right++];
+				else
+					buffer[dst++] = order[left++];
+			}
+			while (left < mid)
+				buffer[dst++] = order[left++];
+			while (right < end)
+				buffer[dst++] = order[right++];
+		}
+		order.swap(buffer);
+	}
+	oracle.finish();
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef INSERTIONCHAIN_HPP
+# define INSERTIONCHAIN_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Main chain used by the merge-insertion step on large ranges.
+// Elements live in an array-backed implicit treap ordered by rank, so
+// reading the element at a rank and inserting at a rank are O(log n)
+// instead of shifting the tail of a contiguous container on every insert.
+// Each value is written once on the way in and once on the way out.
+template <typename T>
+class InsertionChain
+{
+private:
+	struct Node
+	{
+		T			value;
+		unsigned	priority;
+		size_t		parent;
+		size_t		left;
+		size_t		right;
+		size_t		leftSize;	// cached so a rank probe touches one node per level
+		size_t		size;
+	};
+
+	// nodes_[0] is the empty sentinel, so child index 0 means "no child"
+	std::vector<Node>	nodes_;
+	size_t				root_;
+	unsigned			seed_;
+
+	unsigned nextPriority();
+	void update(size_t node);
+	void split(size_t tree, size_t rank, size_t& left, size_t& right);
+	size_t insertNode(size_t tree, size_t rank, size_t node);
+
+public:
+	InsertionChain();
+	InsertionChain(const InsertionChain& other);
+	InsertionChain& operator=(const InsertionChain& other);
+	~InsertionChain();
+
+	void clear();
+	void reserve(size_t n);
+	size_t size() const;
+	size_t capacityBytes() const;
+
+	const T& at(size_t rank) const;
+
+	// Returns a handle that stays valid until clear(); rankOf() turns it
+	// into the element's current rank by walking parent links
+	size_t insertAt(size_t rank, const T& value);
+	size_t rankOf(size_t handle) const;
+	size_t handleAt(size_t rank) const;
+
+	// Handles are issued in insertion order: every handle below mark()
+	// belongs to an element inserted before mark() was taken
+	size_t mark() const;
+
+	// Binary search over ranks [0, limit): first rank whose element is not
+	// `before` the searched value. Probes the same ranks a lower_bound over
+	// the materialized chain would; the predicate is called as
+	// before(value, rank, handle).
+	template <typename Predicate>
+	size_t partitionPoint(size_t limit, Predicate before) const;
+
+	// Write the chain in rank order; the destination must hold size() items.
+	// Walks parent links, so it needs no stack.
+	template <typename OutputIterator>
+	void copyTo(OutputIterator dst) const;
+};
+
+// Same interface for the last few recursion levels (at most Capacity
+// elements): a fixed array of handles in rank order, no allocation and no
+// tree walk. Probes the same ranks as InsertionChain, so the comparisons
+// made through either chain are identical.
+template <typename T, size_t Capacity>
+class SmallChain
+{
+private:
+	T		values_[Capacity];	// indexed by handle
+	size_t	order_[Capacity];	// handles in rank order
+	size_t	size_;
+
+public:
+	SmallChain() : size_(0) {}
+
+	void clear() { size_ = 0; }
+	size_t size() const { return size_; }
+	const T& at(size_t rank) const { return values_[order_[rank]]; }
+	size_t handleAt(size_t rank) const { return order_[rank]; }
+	size_t mark() const { return size_; }
+
+	size_t insertAt(size_t rank, const T& value)
+	{
+		size_t handle = size_;
+		values_[handle] = value;
+		for (size_t r = size_; r > rank; r--)
+			order_[r] = order_[r - 1];
+		order_[rank] = handle;
+		size_++;
+		return handle;
+	}
+
+	size_t rankOf(size_t handle) const
+	{
+		size_t rank = 0;
+		while (order_[rank] != handle)
+			rank++;
+		return rank;
+	}
+
+	template <typename Predicate>
+	size_t partitionPoint(size_t limit, Predicate before) const
+	{
+		size_t left = 0;
+		size_t right = limit;
+		while (left < right)
+		{
+			size_t mid = left + (right - left) / 2;
+			if (before(values_[order_[mid]], mid, order_[mid]))
+				left = mid + 1;
+			else
+				right = mid;
+		}
+		return left;
+	}
+
+	template <typename OutputIterator>
+	void copyTo(OutputIterator dst) const
+	{
+		for (size_t r = 0; r < size_; r++)
+			*dst++ = values_[order_[r]];
+	}
+};
+
+#include "InsertionChain.tpp"
+
+#endif
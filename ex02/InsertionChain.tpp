@@ -0,0 +1,298 @@
+#ifndef INSERTIONCHAIN_TPP
+# define INSERTIONCHAIN_TPP
+
+template <typename T>
+InsertionChain<T>::InsertionChain() : nodes_(1), root_(0), seed_(2463534242u)
+{
+	nodes_[0].priority = 0;
+	nodes_[0].parent = 0;
+	nodes_[0].left = 0;
+	nodes_[0].right = 0;
+	nodes_[0].leftSize = 0;
+	nodes_[0].size = 0;
+}
+
+template <typename T>
+InsertionChain<T>::InsertionChain(const InsertionChain& other)
+	: nodes_(other.nodes_), root_(other.root_), seed_(other.seed_)
+{
+}
+
+template <typename T>
+InsertionChain<T>& InsertionChain<T>::operator=(const InsertionChain& other)
+{
+	if (this != &other)
+	{
+		nodes_ = other.nodes_;
+		root_ = other.root_;
+		seed_ = other.seed_;
+	}
+	return *this;
+}
+
+template <typename T>
+InsertionChain<T>::~InsertionChain() {}
+
+// xorshift32: cheap, deterministic priorities keep runs reproducible
+template <typename T>
+unsigned InsertionChain<T>::nextPriority()
+{
+	seed_ ^= seed_ << 13;
+	seed_ ^= seed_ >> 17;
+	seed_ ^= seed_ << 5;
+	return seed_ | 1u;
+}
+
+template <typename T>
+void InsertionChain<T>::update(size_t node)
+{
+	nodes_[node].leftSize = nodes_[nodes_[node].left].size;
+	nodes_[node].size = nodes_[node].leftSize + nodes_[nodes_[node].right].size + 1;
+	// The sentinel's parent is scribbled over here; it is never read
+	nodes_[nodes_[node].left].parent = node;
+	nodes_[nodes_[node].right].parent = node;
+}
+
+// Split a subtree into its first `rank` elements and the rest
+template <typename T>
+void InsertionChain<T>::split(size_t tree, size_t rank, size_t& left, size_t& right)
+{
+	if (tree == 0)
+	{
+		left = 0;
+		right = 0;
+		return;
+	}
+
+	size_t leftSize = nodes_[tree].leftSize;
+	size_t lower, upper;
+	if (rank <= leftSize)
+	{
+		split(nodes_[tree].left, rank, lower, upper);
+		nodes_[tree].left = upper;
+		left = lower;
+		right = tree;
+	}
+	else
+	{
+		split(nodes_[tree].right, rank - leftSize - 1, lower, upper);
+		nodes_[tree].right = lower;
+		left = tree;
+		right = upper;
+	}
+	update(tree);
+}
+
+template <typename T>
+size_t InsertionChain<T>::insertNode(size_t tree, size_t rank, size_t node)
+{
+	if (tree == 0)
+		return node;
+
+	if (nodes_[node].priority > nodes_[tree].priority)
+	{
+		size_t lower, upper;
+		split(tree, rank, lower, upper);
+		nodes_[node].left = lower;
+		nodes_[node].right = upper;
+		update(node);
+		return node;
+	}
+
+	size_t leftSize = nodes_[tree].leftSize;
+	if (rank <= leftSize)
+	{
+		size_t child = insertNode(nodes_[tree].left, rank, node);
+		nodes_[tree].left = child;
+		nodes_[child].parent = tree;
+		nodes_[tree].leftSize++;
+	}
+	else
+	{
+		size_t child = insertNode(nodes_[tree].right, rank - leftSize - 1, node);
+		nodes_[tree].right = child;
+		nodes_[child].parent = tree;
+	}
+	nodes_[tree].size++;
+	return tree;
+}
+
+template <typename T>
+void InsertionChain<T>::clear()
+{
+	nodes_.resize(1);
+	root_ = 0;
+}
+
+template <typename T>
+void InsertionChain<T>::reserve(size_t n)
+{
+	nodes_.reserve(n + 1);
+}
+
+template <typename T>
+size_t InsertionChain<T>::size() const
+{
+	return nodes_[root_].size;
+}
+
+template <typename T>
+size_t InsertionChain<T>::capacityBytes() const
+{
+	return nodes_.capacity() * sizeof(Node);
+}
+
+template <typename T>
+size_t InsertionChain<T>::handleAt(size_t rank) const
+{
+	size_t node = root_;
+	while (true)
+	{
+		size_t leftSize = nodes_[node].leftSize;
+		if (rank < leftSize)
+			node = nodes_[node].left;
+		else if (rank == leftSize)
+			return node;
+		else
+		{
+			rank -= leftSize + 1;
+			node = nodes_[node].right;
+		}
+	}
+}
+
+template <typename T>
+const T& InsertionChain<T>::at(size_t rank) const
+{
+	return nodes_[handleAt(rank)].value;
+}
+
+template <typename T>
+size_t InsertionChain<T>::mark() const
+{
+	return nodes_.size();
+}
+
+template <typename T>
+size_t InsertionChain<T>::insertAt(size_t rank, const T& value)
+{
+	Node fresh;
+	fresh.value = value;
+	fresh.priority = nextPriority();
+	fresh.parent = 0;
+	fresh.left = 0;
+	fresh.right = 0;
+	fresh.leftSize = 0;
+	fresh.size = 1;
+	nodes_.push_back(fresh);
+	size_t node = nodes_.size() - 1;
+	root_ = insertNode(root_, rank, node);
+	nodes_[root_].parent = 0;
+	return node;
+}
+
+template <typename T>
+size_t InsertionChain<T>::rankOf(size_t handle) const
+{
+	size_t rank = nodes_[handle].leftSize;
+	size_t node = handle;
+	while (node != root_)
+	{
+		size_t parent = nodes_[node].parent;
+		if (nodes_[parent].right == node)
+			rank += nodes_[parent].leftSize + 1;
+		node = parent;
+	}
+	return rank;
+}
+
+// The probes are the ranks a plain lower_bound would read. Between probes
+// the walk only narrows to the smallest subtree still covering the search
+// window, so a whole search costs about one root-to-leaf path.
+template <typename T>
+template <typename Predicate>
+size_t InsertionChain<T>::partitionPoint(size_t limit, Predicate before) const
+{
+	size_t left = 0;
+	size_t right = limit;
+	size_t subtree = root_;
+	size_t base = 0;
+
+	while (left < right)
+	{
+		size_t mid = left + (right - left) / 2;
+
+		// Locate rank `mid` below the current subtree
+		size_t node = subtree;
+		size_t offset = base;
+		while (true)
+		{
+			size_t nodeRank = offset + nodes_[node].leftSize;
+			if (mid < nodeRank)
+				node = nodes_[node].left;
+			else if (mid == nodeRank)
+				break;
+			else
+			{
+				offset = nodeRank + 1;
+				node = nodes_[node].right;
+			}
+		}
+
+		if (before(nodes_[node].value, mid, node))
+			left = mid + 1;
+		else
+			right = mid;
+
+		// Narrow the subtree to the remaining window [left, right)
+		while (subtree != 0 && left < right)
+		{
+			size_t nodeRank = base + nodes_[subtree].leftSize;
+			if (right <= nodeRank)
+				subtree = nodes_[subtree].left;
+			else if (left > nodeRank)
+			{
+				base = nodeRank + 1;
+				subtree = nodes_[subtree].right;
+			}
+			else
+				break;
+		}
+	}
+
+	return left;
+}
+
+// In-order walk over parent links: from a node, the next one is the
+// leftmost of its right subtree, or else the first ancestor reached from
+// a left child
+template <typename T>
+template <typename OutputIterator>
+void InsertionChain<T>::copyTo(OutputIterator dst) const
+{
+	if (root_ == 0)
+		return;
+
+	size_t node = root_;
+	while (nodes_[node].left != 0)
+		node = nodes_[node].left;
+
+	while (true)
+	{
+		*dst++ = nodes_[node].value;
+		if (nodes_[node].right != 0)
+		{
+			node = nodes_[node].right;
+			while (nodes_[node].left != 0)
+				node = nodes_[node].left;
+			continue;
+		}
+		while (node != root_ && nodes_[nodes_[node].parent].right == node)
+			node = nodes_[node].parent;
+		if (node == root_)
+			return;
+		node = nodes_[node].parent;
+	}
+}
+
+#endif
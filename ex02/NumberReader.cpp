@@ -0,0 +1,165 @@
+#include "NumberReader.hpp"
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+NumberReader::NumberReader() : binary_(false), open_(false) {}
+
+// Orthodox Canonical Form - a reader owns its descriptor, so it isn't copied
+NumberReader::NumberReader(const NumberReader& other) : binary_(other.binary_), open_(false) {}
+NumberReader& NumberReader::operator=(const NumberReader& other) { (void)other; return *this; }
+
+NumberReader::~NumberReader() {}
+
+static bool isSeparator(char c)
+{
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool NumberReader::parseToken(const char* begin, const char* end, int& out)
+{
+	if (begin < end && *begin == '+')
+		begin++;
+
+	// INT_MAX has 10 digits; anything longer or starting with '0' is out
+	size_t length = end - begin;
+	if (length == 0 || length > 10 || *begin == '0')
+		return false;
+
+	// At most 10 decimal digits, each checked before it is added: the
+	// accumulator stays below 10^10 and can't overflow. A byte below '0'
+	// wraps to a large unsigned value, so one test catches both sides.
+	unsigned long long acc = 0;
+	for (const char* p = begin; p < end; p++)
+	{
+		unsigned digit = static_cast<unsigned char>(*p) - static_cast<unsigned>('0');
+		if (digit > 9)
+			return false;
+		acc = acc * 10 + digit;
+	}
+
+	if (acc > static_cast<unsigned long long>(INT_MAX))
+		return false;
+	out = static_cast<int>(acc);
+	return true;
+}
+
+bool NumberReader::open(const std::string& path, bool binary, size_t blockBytes)
+{
+	binary_ = binary;
+	if (path == "-")
+		block_.attach(STDIN_FILENO, blockBytes);
+	else if (!block_.open(path, blockBytes))
+		return false;
+	open_ = true;
+	return true;
+}
+
+// Tokens are only parsed once a separator (or the end of input) shows
+// they are complete; a cut-off token waits for the next refill. The scan
+// runs on local copies of the block's bounds, handed back before every
+// refill and on return.
+bool NumberReader::readText(std::vector<int>& out, size_t maxCount)
+{
+	const char* data = block_.data();
+	size_t begin = block_.begin();
+	size_t end = block_.end();
+	size_t taken = 0;
+
+	while (taken < maxCount)
+	{
+		while (begin < end && isSeparator(data[begin]))
+			begin++;
+
+		size_t token = begin;
+		while (token < end && !isSeparator(data[token]))
+			token++;
+
+		if (token == end && !block_.eof())
+		{
+			block_.consume(begin - block_.begin());
+			// A whole block without a separator can't be a valid token
+			if (block_.full())
+				return false;
+			block_.refill();
+			if (block_.failed())
+				return false;
+			data = block_.data();
+			begin = block_.begin();
+			end = block_.end();
+			continue;
+		}
+		if (begin == end)
+			break;
+
+		int value;
+		if (!parseToken(data + begin, data + token, value))
+			return false;
+		out.push_back(value);
+		taken++;
+		begin = token;
+	}
+	block_.consume(begin - block_.begin());
+	return true;
+}
+
+bool NumberReader::readBinary(std::vector<int>& out, size_t maxCount)
+{
+	const char* data = block_.data();
+	size_t begin = block_.begin();
+	size_t end = block_.end();
+	size_t taken = 0;
+
+	while (taken < maxCount)
+	{
+		if (end - begin < 4)
+		{
+			block_.consume(begin - block_.begin());
+			// A trailing partial value means the input is not a whole number of ints
+			if (block_.eof())
+				return begin == end && !block_.failed();
+			block_.refill();
+			if (block_.failed())
+				return false;
+			data = block_.data();
+			begin = block_.begin();
+			end = block_.end();
+			continue;
+		}
+
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data + begin);
+		unsigned long value = static_cast<unsigned long>(bytes[0])
+			| (static_cast<unsigned long>(bytes[1]) << 8)
+			| (static_cast<unsigned long>(bytes[2]) << 16)
+			| (static_cast<unsigned long>(bytes[3]) << 24);
+		if (value == 0 || value > static_cast<unsigned long>(INT_MAX))
+			return false;
+		out.push_back(static_cast<int>(value));
+		taken++;
+		begin += 4;
+	}
+	block_.consume(begin - block_.begin());
+	return true;
+}
+
+bool NumberReader::read(std::vector<int>& out, size_t maxCount)
+{
+	if (!open_)
+		return false;
+	return binary_ ? readBinary(out, maxCount) : readText(out, maxCount);
+}
+
+bool NumberReader::readFile(const std::string& path, bool binary, std::vector<int>& out)
+{
+	NumberReader reader;
+	if (!reader.open(path, binary))
+		return false;
+
+	// Binary files have a known count: size the vector once
+	struct stat info;
+	if (binary && fstat(reader.block_.fd(), &info) == 0 && S_ISREG(info.st_mode))
+		out.reserve(info.st_size / 4);
+
+	return reader.read(out, static_cast<size_t>(-1)) && !out.empty();
+}
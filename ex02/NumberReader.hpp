@@ -0,0 +1,47 @@
+#ifndef NUMBERREADER_HPP
+# define NUMBERREADER_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "BlockReader.hpp"
+
+// Bulk ingestion of positive ints, for inputs far beyond what fits in argv.
+// Streams are read in large blocks by a BlockReader and parsed in place; no
+// per-number std::string is ever built. A reader hands out values in
+// batches, so inputs larger than memory can be consumed piece by piece.
+class NumberReader
+{
+private:
+	BlockReader	block_;
+	bool		binary_;
+	bool		open_;
+
+	NumberReader(const NumberReader& other);
+	NumberReader& operator=(const NumberReader& other);
+
+	bool readText(std::vector<int>& out, size_t maxCount);
+	bool readBinary(std::vector<int>& out, size_t maxCount);
+
+public:
+	NumberReader();
+	~NumberReader();
+
+	// path "-" is stdin. Text is whitespace-separated tokens; binary is
+	// packed 32-bit little-endian values with the same 1..INT_MAX range.
+	// A text token longer than blockBytes is rejected.
+	bool open(const std::string& path, bool binary, size_t blockBytes = BlockReader::defaultBlockSize);
+
+	// Appends up to maxCount values. Fails on any invalid value or read
+	// error; at the end of the input it succeeds without appending.
+	bool read(std::vector<int>& out, size_t maxCount);
+
+	// One token: optional '+', digits, no leading zero, 1..INT_MAX.
+	// The digit loop has no early exit; validity is checked once at the end.
+	static bool parseToken(const char* begin, const char* end, int& out);
+
+	// The whole input at once; an empty input is an error
+	static bool readFile(const std::string& path, bool binary, std::vector<int>& out);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef PARALLELSORT_HPP
+# define PARALLELSORT_HPP
+
+#include <vector>
+#include <cstddef>
+#include <pthread.h>
+#include "FordJohnson.hpp"
+
+// Chunks smaller than this are not worth a thread
+static const size_t parallelMinChunk = 4096;
+
+// Parallel mode: the keys are cut into `jobs` contiguous chunks, each chunk
+// is sorted by its own merge-insertion engine on its own thread, then
+// neighbouring sorted runs are merged pairwise with two ping-pong buffers.
+// Every merge round is cut at co-ranks (merge path) into `jobs` segments
+// that merge on their own threads, so the final merge is parallel too.
+//
+// This is chunk sort plus merge, not a parallel Ford-Johnson: the pairing,
+// the recursion on the larger elements and the pend insertion all stay
+// inside the sequential engine of each chunk. The price is comparisons:
+// the log2(jobs) merge rounds add up to n - 1 each on top of the chunks'
+// near-optimal counts, plus O(jobs log n) for the co-ranks.
+//
+// Order contract: the sorted values are the sequential sort's, and with
+// a strict weak order that has no ties (ints, say) the output is identical
+// to it. Equivalent keys keep the chunk engine's order within a chunk and
+// come out in chunk order across chunks (merges take from the left run on
+// ties), so for a given `jobs` the order is reproducible, but it may
+// differ from the sequential sort's order of equivalent keys, which is not
+// stable either.
+template <typename RandomIt, typename Compare>
+void sortKeysParallel(RandomIt keys, size_t n, Compare comp, SortPolicy policy, size_t jobs,
+	SortStats& stats, std::vector<size_t>& order);
+
+// Whole-container entry point; jobs <= 1 is the sequential sort
+template <typename Container, typename Compare>
+SortStats mergeInsertionSortParallel(Container& c, Compare comp, SortPolicy policy, size_t jobs);
+
+// Runs task.run() for every task, one thread each (the first on the
+// calling thread). Falls back to running inline if a thread can't start.
+template <typename Task>
+void runConcurrently(std::vector<Task>& tasks);
+
+#include "ParallelSort.tpp"
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef PARALLELSORT_TPP
+# define PARALLELSORT_TPP
+
+template <typename Task>
+void* runTask(void* arg)
+{
+	static_cast<Task*>(arg)->run();
+	return NULL;
+}
+
+template <typename Task>
+void runConcurrently(std::vector<Task>& tasks)
+{
+	std::vector<pthread_t> threads(tasks.size());
+	std::vector<bool> started(tasks.size(), false);
+
+	for (size_t i = 1; i < tasks.size(); i++)
+		started[i] = (pthread_create(&threads[i], NULL, &runTask<Task>, &tasks[i]) == 0);
+	if (!tasks.empty())
+		tasks[0].run();
+	for (size_t i = 1; i < tasks.size(); i++)
+	{
+		if (started[i])
+			pthread_join(threads[i], NULL);
+		else
+			tasks[i].run();
+	}
+}
+
+// Sort keys [begin, end) and write their global ids into order[begin, end)
+template <typename RandomIt, typename Compare>
+struct ChunkSortTask
+{
+	RandomIt	keys;
+	Compare		comp;
+	SortPolicy	policy;
+	size_t		begin;
+	size_t		end;
+	size_t*		order;
+	SortStats	stats;
+
+	ChunkSortTask(RandomIt k, Compare c, SortPolicy p, size_t b, size_t e, size_t* o)
+		: keys(k), comp(c), policy(p), begin(b), end(e), order(o) {}
+
+	void run()
+	{
+		std::vector<size_t> local;
+		sortKeys(keys + begin, end - begin, comp, policy, stats, local);
+		for (size_t i = 0; i < local.size(); i++)
+			order[begin + i] = begin + local[i];
+	}
+};
+
+// Merge one segment of two sorted runs: src[left, leftEnd) and
+// src[right, rightEnd) into dst from `out` on
+template <typename RandomIt, typename Compare>
+struct RunMergeTask
+{
+	RandomIt		keys;
+	Compare			comp;
+	const size_t*	src;
+	size_t*			dst;
+	size_t			left;
+	size_t			leftEnd;
+	size_t			right;
+	size_t			rightEnd;
+	size_t			out;
+	SortStats		stats;
+
+	RunMergeTask(RandomIt k, Compare c, const size_t* s, size_t* d, size_t l, size_t le, size_t r,
+		size_t re, size_t o)
+		: keys(k), comp(c), src(s), dst(d), left(l), leftEnd(le), right(r), rightEnd(re), out(o) {}
+
+	void run()
+	{
+		// Take from the right run only when strictly smaller
+		while (left < leftEnd && right < rightEnd)
+		{
+			stats.comparisons++;
+			if (comp(keys[src[right]], keys[src[left]]))
+				dst[out++] = src[right++];
+			else
+				dst[out++] = src[left++];
+		}
+		while (left < leftEnd)
+			dst[out++] = src[left++];
+		while (right < rightEnd)
+			dst[out++] = src[right++];
+	}
+};
+
+// Co-rank (merge path): how many of the first k values of the merge of
+// src[leftBegin, leftEnd) and src[rightBegin, rightEnd) come from the
+// left run, ties going left as in RunMergeTask. Binary search, so the
+// k-th output position of a merge is found in O(log n) comparisons.
+template <typename RandomIt, typename Compare>
+size_t coRank(RandomIt keys, Compare comp, const size_t* src, size_t leftBegin, size_t leftEnd,
+	size_t rightBegin, size_t rightEnd, size_t k, SortStats& stats)
+{
+	size_t leftSize = leftEnd - leftBegin;
+	size_t rightSize = rightEnd - rightBegin;
+	size_t low = (k > rightSize) ? k - rightSize : 0;
+	size_t high = (k < leftSize) ? k : leftSize;
+
+	while (low < high)
+	{
+		size_t i = low + (high - low) / 2;
+		size_t j = k - i;
+		// The left value i is among the first k unless the right value
+		// j - 1 is strictly smaller
+		stats.comparisons++;
+		if (!comp(keys[src[rightBegin + j - 1]], keys[src[leftBegin + i]]))
+			low = i + 1;
+		else
+			high = i;
+	}
+	return low;
+}
+
+static inline void addStats(SortStats& total, const SortStats& part)
+{
+	total.comparisons += part.comparisons;
+	total.speculative += part.speculative;
+	total.boundaryHits += part.boundaryHits;
+	total.rounds += part.rounds;
+	total.allocations += part.allocations;
+	total.peakBytes += part.peakBytes;	// chunks run at once: their buffers coexist
+	if (part.largestRound > total.largestRound)
+		total.largestRound = part.largestRound;
+}
+
+template <typename RandomIt, typename Compare>
+void sortKeysParallel(RandomIt keys, size_t n, Compare comp, SortPolicy policy, size_t jobs,
+	SortStats& stats, std::vector<size_t>& order)
+{
+	typedef ChunkSortTask<RandomIt, Compare> ChunkTask;
+	typedef RunMergeTask<RandomIt, Compare> MergeTask;
+
+	if (jobs > n / parallelMinChunk)
+		jobs = n / parallelMinChunk;
+	if (jobs <= 1)
+	{
+		sortKeys(keys, n, comp, policy, stats, order);
+		return;
+	}
+
+	// Phase 1: sort every chunk on its own thread
+	order.resize(n);
+	recordBuffer(stats, order);
+	std::vector<size_t> bounds;
+	std::vector<ChunkTask> chunks;
+	for (size_t j = 0; j < jobs; j++)
+	{
+		bounds.push_back(n * j / jobs);
+		chunks.push_back(ChunkTask(keys, comp, policy, n * j / jobs, n * (j + 1) / jobs, &order[0]));
+	}
+	bounds.push_back(n);
+	runConcurrently(chunks);
+	for (size_t j = 0; j < chunks.size(); j++)
+		addStats(stats, chunks[j].stats);
+
+	// Phase 2: merge neighbouring runs until one is left. Each merge is
+	// cut at co-ranks into segments that merge independently, so every
+	// round keeps all `jobs` threads busy, the last single merge included.
+	std::vector<size_t> buffer(n);
+	recordBuffer(stats, buffer);
+	while (bounds.size() > 2)
+	{
+		std::vector<MergeTask> merges;
+		std::vector<size_t> next;
+		size_t runs = bounds.size() - 1;
+		size_t pairs = (runs + 1) / 2;
+		size_t segments = (jobs > pairs) ? jobs / pairs : 1;
+		for (size_t r = 0; r < runs; r += 2)
+		{
+			size_t begin = bounds[r];
+			size_t end = (r + 2 <= runs) ? bounds[r + 2] : bounds[r + 1];
+			size_t mid = (r + 2 <= runs) ? bounds[r + 1] : end;
+			size_t left = begin;
+			size_t right = mid;
+			for (size_t s = 1; s <= segments; s++)
+			{
+				size_t k = (end - begin) * s / segments;
+				size_t leftEnd = begin + coRank(keys, comp, &order[0], begin, mid, mid, end, k, stats);
+				size_t rightEnd = mid + (k - (leftEnd - begin));
+				merges.push_back(MergeTask(keys, comp, &order[0], &buffer[0], left, leftEnd, right, rightEnd,
+					left + (right - mid)));
+				left = leftEnd;
+				right = rightEnd;
+			}
+			next.push_back(begin);
+		}
+		next.push_back(n);
+		runConcurrently(merges);
+		for (size_t j = 0; j < merges.size(); j++)
+			addStats(stats, merges[j].stats);
+		order.swap(buffer);
+		bounds.swap(next);
+	}
+}
+
+template <typename Container, typename Compare>
+SortStats mergeInsertionSortParallel(Container& c, Compare comp, SortPolicy policy, size_t jobs)
+{
+	typedef typename ContainerTraits<Container>::category Category;
+
+	SortStats stats;
+	if (c.size() <= 1)
+		return stats;
+
+	std::vector<size_t> order;
+	sortKeysParallel(keyAccess(c, Category()), c.size(), comp, policy, jobs, stats, order);
+	applyPermutation(c, order);
+	return stats;
+}
+
+#endif
@@ -6,297 +6,326 @@ PmergeMe::PmergeMe(const PmergeMe& other) { (void)other; }
 PmergeMe& PmergeMe::operator=(const PmergeMe& other) { (void)other; return *this; }
 PmergeMe::~PmergeMe() {}
 
-// Strict parsing with overflow protection
+// Strict parsing with overflow protection (shared with bulk input)
 bool PmergeMe::parsePositiveInt(const std::string& s, int& out)
 {
-	if (s.empty())
-		return false;
+	return NumberReader::parseToken(s.data(), s.data() + s.size(), out);
+}
 
-	size_t i = 0;
-	// Check for optional leading '+'
-	if (s[0] == '+')
-		i = 1;
+PmergeMe::Options::Options() : policy(FewestComparisons), jobs(1), input(), binary(false), show(showAll), memory(0), tempDir() {}
 
-	if (i >= s.length())
-		return false;
+// Byte count with an optional K, M or G suffix (powers of 1024)
+bool PmergeMe::parseMemory(const std::string& s, size_t& out)
+{
+	size_t unit = 1;
+	std::string digits = s;
+	if (!s.empty())
+	{
+		char suffix = s[s.size() - 1];
+		if (suffix == 'K')
+			unit = 1 << 10;
+		else if (suffix == 'M')
+			unit = 1 << 20;
+		else if (suffix == 'G')
+			unit = 1 << 30;
+		if (unit != 1)
+			digits = s.substr(0, s.size() - 1);
+	}
 
-	// Reject leading zeros (except for single '0' which is handled later)
-	if (s[i] == '0' && i + 1 < s.length())
+	int value;
+	if (!parsePositiveInt(digits, value))
 		return false;
+	out = static_cast<size_t>(value) * unit;
+	return out >= ExternalSort::minMemory;
+}
 
-	// Verify all remaining characters are digits
-	for (size_t j = i; j < s.length(); j++)
+// Options are "--name=value" and must come before the first number
+bool PmergeMe::parseOption(const std::string& arg, Options& options)
+{
+	if (arg == "--policy=optimal")
+		options.policy = FewestComparisons;
+	else if (arg == "--policy=fast")
+		options.policy = FastestWallClock;
+	else if (arg.compare(0, 7, "--jobs=") == 0)
 	{
-		if (s[j] < '0' || s[j] > '9')
+		int jobs;
+		if (!parsePositiveInt(arg.substr(7), jobs) || static_cast<size_t>(jobs) > maxJobs)
 			return false;
+		options.jobs = jobs;
 	}
-
-	// Manual overflow-safe conversion
-	unsigned long long acc = 0;
-	for (size_t j = i; j < s.length(); j++)
+	else if (arg.compare(0, 8, "--input=") == 0 && arg.size() > 8)
+		options.input = arg.substr(8);
+	else if (arg == "--binary")
+		options.binary = true;
+	else if (arg.compare(0, 9, "--memory=") == 0)
 	{
-		int digit = s[j] - '0';
-		// Check for overflow before accumulating
-		if (acc > (static_cast<unsigned long long>(INT_MAX) - digit) / 10)
+		if (!parseMemory(arg.substr(9), options.memory))
 			return false;
-		acc = acc * 10 + digit;
 	}
-
-	// Check final value is positive and within INT_MAX
-	if (acc == 0 || acc > static_cast<unsigned long long>(INT_MAX))
+	else if (arg.compare(0, 11, "--temp-dir=") == 0 && arg.size() > 11)
+		options.tempDir = arg.substr(11);
+	else if (arg == "--show=all")
+		options.show = showAll;
+	else if (arg == "--show=none")
+		options.show = 0;
+	else if (arg.compare(0, 7, "--show=") == 0)
+	{
+		int shown;
+		if (!parsePositiveInt(arg.substr(7), shown))
+			return false;
+		options.show = shown;
+	}
+	else
 		return false;
-
-	out = static_cast<int>(acc);
 	return true;
 }
 
-bool PmergeMe::parseArgs(int argc, char** argv, std::vector<int>& out)
+bool PmergeMe::parseArgs(int argc, char** argv, std::vector<int>& out, Options& options)
 {
-	if (argc < 2)
-		return false;
+	int first = 1;
+	while (first < argc && std::string(argv[first]).compare(0, 2, "--") == 0)
+	{
+		if (!parseOption(argv[first], options))
+			return false;
+		first++;
+	}
 
 	out.clear();
-	out.reserve(argc - 1);
 
-	for (int i = 1; i < argc; i++)
+	// An external sort streams --input itself, and needs one
+	if (options.memory != 0)
+		return first == argc && !options.input.empty();
+
+	// Numbers come either from --input or from the command line, not both
+	if (!options.input.empty())
+		return first == argc && NumberReader::readFile(options.input, options.binary, out);
+	if (options.binary || first >= argc)
+		return false;
+
+	out.reserve(argc - first);
+	for (int i = first; i < argc; i++)
 	{
 		int value;
-		if (!parsePositiveInt(std::string(argv[i]), value))
+		if (!NumberReader::parseToken(argv[i], argv[i] + std::strlen(argv[i]), value))
 			return false;
 		out.push_back(value);
 	}
 	return true;
 }
 
-double PmergeMe::getTimeDifference(const struct timeval& start, const struct timeval& end)
+// Microseconds between two CLOCK_MONOTONIC readings
+double PmergeMe::getTimeDifference(const struct timespec& start, const struct timespec& end)
 {
-	return (end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_usec - start.tv_usec);
+	return (end.tv_sec - start.tv_sec) * 1000000.0 + (end.tv_nsec - start.tv_nsec) / 1000.0;
 }
 
-// Generate Jacobsthal indices for optimal insertion order
-std::vector<size_t> PmergeMe::jacobsthalIndices(size_t mCount)
+// "label 1 2 3\n", cut to the first `show` values followed by "[...]"
+void PmergeMe::printSequence(OutputBuffer& out, const char* label, const std::vector<int>& values, size_t show)
 {
-	std::vector<size_t> indices;
-	if (mCount == 0)
-		return indices;
-
-	// For simplicity, just insert in sequential order for now
-	// This is still correct Ford-Johnson, just not optimally ordered
-	for (size_t i = 0; i < mCount; i++)
-		indices.push_back(i);
-
-	return indices;
-}
-
-// Binary insertion for vector
-void PmergeMe::binaryInsertVector(std::vector<int>& chain, int value)
-{
-	size_t left = 0;
-	size_t right = chain.size();
+	if (show == 0)
+		return;
 
-	while (left < right)
+	out.append(label);
+	size_t count = values.size() < show ? values.size() : show;
+	for (size_t i = 0; i < count; i++)
 	{
-		size_t mid = left + (right - left) / 2;
-		if (chain[mid] < value)
-			left = mid + 1;
-		else
-			right = mid;
+		if (i > 0)
+			out.append(' ');
+		out.appendNumber(static_cast<long>(values[i]));
 	}
-
-	chain.insert(chain.begin() + left, value);
+	if (count < values.size())
+		out.append(" [...]");
+	out.append('\n');
 }
 
-// Binary insertion for deque
-void PmergeMe::binaryInsertDeque(std::deque<int>& chain, int value)
+// "Time to process a range of N elements with <label>T us (...)"; buckets
+// is only shown when non-zero
+void PmergeMe::printTiming(OutputBuffer& out, size_t size, const char* label, double micros,
+	const SortStats& stats, size_t buckets)
 {
-	size_t left = 0;
-	size_t right = chain.size();
-
-	while (left < right)
+	out.append("Time to process a range of ");
+	out.appendNumber(static_cast<unsigned long>(size));
+	out.append(" elements with ");
+	out.append(label);
+	out.appendFixed(micros, 5);
+	out.append(" us (");
+	out.appendNumber(static_cast<unsigned long>(stats.comparisons));
+	out.append(" comparisons, ");
+	if (buckets != 0)
 	{
-		size_t mid = left + (right - left) / 2;
-		if (chain[mid] < value)
-			left = mid + 1;
-		else
-			right = mid;
+		out.appendNumber(static_cast<unsigned long>(buckets));
+		out.append(" buckets, ");
 	}
-
-	chain.insert(chain.begin() + left, value);
+	out.appendNumber(static_cast<unsigned long>(stats.peakBytes));
+	out.append(" bytes in ");
+	out.appendNumber(static_cast<unsigned long>(stats.allocations));
+	out.append(" allocations)\n");
 }
 
-// Pairing and sorting for vector
-void PmergeMe::pairAndSortVector(const std::vector<int>& in, std::vector<int>& maxes, std::vector<int>& mins, int& straggler, bool& hasStraggler)
+// Streams one Before/After line for the external sort, cut like printSequence
+class LinePrinter : public ExternalSort::ValueSink
 {
-	size_t n = in.size();
-	hasStraggler = (n % 2 == 1);
-	
-	if (hasStraggler)
-	{
-		straggler = in[n - 1];
-		n--;
-	}
+private:
+	OutputBuffer&	out_;
+	const char*		label_;
+	size_t			show_;
+	size_t			count_;
+	size_t			start_;		// out_.tell() where the line began
+
+	LinePrinter(const LinePrinter& other);
+	LinePrinter& operator=(const LinePrinter& other);
 
-	size_t pairCount = n / 2;
-	maxes.clear();
-	mins.clear();
-	maxes.reserve(pairCount);
-	mins.reserve(pairCount);
+public:
+	LinePrinter(OutputBuffer& out, const char* label, size_t show)
+		: out_(out), label_(label), show_(show), count_(0), start_(0) {}
 
-	// Create pairs and ensure max > min within each pair
-	for (size_t i = 0; i < pairCount; i++)
+	void put(int value)
 	{
-		int a = in[2 * i];
-		int b = in[2 * i + 1];
-		if (a > b)
-		{
-			maxes.push_back(a);
-			mins.push_back(b);
-		}
-		else
+		if (count_ < show_)
 		{
-			maxes.push_back(b);
-			mins.push_back(a);
+			if (count_ == 0)
+				start_ = out_.tell();
+			out_.append(count_ == 0 ? label_ : " ");
+			out_.appendNumber(static_cast<long>(value));
 		}
+		count_++;
 	}
-}
 
-// Pairing and sorting for deque
-void PmergeMe::pairAndSortDeque(const std::deque<int>& in, std::deque<int>& maxes, std::deque<int>& mins, int& straggler, bool& hasStraggler)
-{
-	size_t n = in.size();
-	hasStraggler = (n % 2 == 1);
-	
-	if (hasStraggler)
+	void end()
 	{
-		straggler = in[n - 1];
-		n--;
+		// Nothing to show, or an empty input that is about to be rejected
+		if (show_ == 0 || count_ == 0)
+			return;
+		if (count_ > show_)
+			out_.append(" [...]");
+		out_.append('\n');
+		out_.flush();
 	}
 
-	size_t pairCount = n / 2;
-	maxes.clear();
-	mins.clear();
-
-	// Create pairs and ensure max > min within each pair
-	for (size_t i = 0; i < pairCount; i++)
+	// Invalid input or an I/O error: take back the partial line, or end
+	// it if part of it is already out (only a very long line gets there)
+	void abort()
 	{
-		int a = in[2 * i];
-		int b = in[2 * i + 1];
-		if (a > b)
-		{
-			maxes.push_back(a);
-			mins.push_back(b);
-		}
-		else
-		{
-			maxes.push_back(b);
-			mins.push_back(a);
-		}
+		if (show_ == 0 || count_ == 0)
+			return;
+		if (!out_.rewind(start_))
+			out_.append('\n');
+		out_.flush();
 	}
-}
+};
 
-// Ford-Johnson algorithm for vector
-void PmergeMe::fordJohnsonVector(std::vector<int>& a)
+// Input that may not fit in memory: sorted in runs, merged from disk.
+// Its time covers reading, spilling, merging and the streamed lines.
+bool PmergeMe::runExternal(const Options& options)
 {
-	if (a.size() <= 1)
-		return;
-
-	std::vector<int> maxes, mins;
-	int straggler;
-	bool hasStraggler;
-
-	// Step 1: Pair adjacent elements and organize by max/min
-	pairAndSortVector(a, maxes, mins, straggler, hasStraggler);
-
-	// Step 2: Recursively sort the sequence of maxes
-	fordJohnsonVector(maxes);
-
-	// Step 3: Build main chain from sorted maxes
-	std::vector<int> mainChain = maxes;
-
-	// Step 4: Insert mins using binary search
-	for (size_t i = 0; i < mins.size(); i++)
-		binaryInsertVector(mainChain, mins[i]);
+	ExternalSort::Config config;
+	config.memory = options.memory;
+	config.policy = options.policy;
+	config.jobs = options.jobs;
+	if (!options.tempDir.empty())
+		config.tempDir = options.tempDir;
+
+	// Both I/O buffers are part of the memory budget
+	size_t ioBytes = ExternalSort::ioBufferBytes(config.memory);
+	NumberReader source;
+	if (!source.open(options.input, options.binary, ioBytes))
+		return false;
 
-	// Step 5: Insert straggler if it exists
-	if (hasStraggler)
-		binaryInsertVector(mainChain, straggler);
+	OutputBuffer out(STDOUT_FILENO, ioBytes);
+	LinePrinter before(out, "Before: ", options.show);
+	LinePrinter after(out, "After: ", options.show);
+	ExternalSort::Report report;
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	bool ok = ExternalSort::sort(source, config, before, after, report);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	out.flush();
+	if (!ok)
+		return false;
 
-	a = mainChain;
+	out.append("Time to process a range of ");
+	out.appendNumber(static_cast<unsigned long>(report.elements));
+	out.append(" elements with external merge : ");
+	out.appendFixed(getTimeDifference(start, end), 5);
+	out.append(" us (");
+	out.appendNumber(static_cast<unsigned long>(report.comparisons));
+	out.append(" comparisons, ");
+	out.appendNumber(static_cast<unsigned long>(report.runs));
+	out.append(" runs of up to ");
+	out.appendNumber(static_cast<unsigned long>(report.runLength));
+	out.append(", ");
+	out.appendNumber(static_cast<unsigned long>(report.fanIn));
+	out.append("-way merge in ");
+	out.appendNumber(static_cast<unsigned long>(report.passes));
+	out.append(" passes, ");
+	out.appendNumber(static_cast<unsigned long>(report.bytesSpilled));
+	out.append(" bytes spilled)\n");
+	out.flush();
+	return true;
 }
 
-// Ford-Johnson algorithm for deque
-void PmergeMe::fordJohnsonDeque(std::deque<int>& a)
+bool PmergeMe::run(const std::vector<int>& input, const Options& options)
 {
-	if (a.size() <= 1)
-		return;
+	if (options.memory != 0)
+		return runExternal(options);
 
-	std::deque<int> maxes, mins;
-	int straggler;
-	bool hasStraggler;
+	OutputBuffer out(STDOUT_FILENO);
+	struct timespec start, end;
+	double vectorTime, dequeTime, blockTime, radixTime, printTime;
+	SortStats vectorStats, dequeStats, blockStats, radixStats;
+	size_t radixBuckets;
 
-	// Step 1: Pair adjacent elements and organize by max/min
-	pairAndSortDeque(a, maxes, mins, straggler, hasStraggler);
-
-	// Step 2: Recursively sort the sequence of maxes
-	fordJohnsonDeque(maxes);
-
-	// Step 3: Build main chain from sorted maxes
-	std::deque<int> mainChain = maxes;
-
-	// Step 4: Insert mins using binary search
-	for (size_t i = 0; i < mins.size(); i++)
-		binaryInsertDeque(mainChain, mins[i]);
-
-	// Step 5: Insert straggler if it exists
-	if (hasStraggler)
-		binaryInsertDeque(mainChain, straggler);
-
-	a = mainChain;
-}
-
-void PmergeMe::run(const std::vector<int>& input)
-{
 	// Output "Before:" line
-	std::cout << "Before: ";
-	for (size_t i = 0; i < input.size(); i++)
-	{
-		if (i > 0)
-			std::cout << " ";
-		std::cout << input[i];
-	}
-	std::cout << std::endl;
-
-	struct timeval start, end;
-	double vectorTime, dequeTime;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	printSequence(out, "Before: ", input, options.show);
+	out.flush();
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printTime = getTimeDifference(start, end);
 
 	// Time vector processing
-	gettimeofday(&start, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	std::vector<int> vectorData = input;
-	fordJohnsonVector(vectorData);
-	gettimeofday(&end, NULL);
+	vectorStats = mergeInsertionSortParallel(vectorData, std::less<int>(), options.policy, options.jobs);
+	clock_gettime(CLOCK_MONOTONIC, &end);
 	vectorTime = getTimeDifference(start, end);
 
 	// Time deque processing
-	gettimeofday(&start, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	std::deque<int> dequeData(input.begin(), input.end());
-	fordJohnsonDeque(dequeData);
-	gettimeofday(&end, NULL);
+	dequeStats = mergeInsertionSortParallel(dequeData, std::less<int>(), options.policy, options.jobs);
+	clock_gettime(CLOCK_MONOTONIC, &end);
 	dequeTime = getTimeDifference(start, end);
 
+	// Time BlockList processing
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	BlockList<int> blockData(input.begin(), input.end());
+	blockStats = mergeInsertionSortParallel(blockData, std::less<int>(), options.policy, options.jobs);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	blockTime = getTimeDifference(start, end);
+
+	// Time the radix-partitioned vector: cache-sized buckets, each merge-insertion sorted
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	std::vector<int> radixData = input;
+	radixStats = RadixPartition::sort(radixData, options.policy, options.jobs, radixBuckets);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	radixTime = getTimeDifference(start, end);
+
 	// Output "After:" line (using vector result)
-	std::cout << "After: ";
-	for (size_t i = 0; i < vectorData.size(); i++)
-	{
-		if (i > 0)
-			std::cout << " ";
-		std::cout << vectorData[i];
-	}
-	std::cout << std::endl;
-
-	// Output timing information
-	std::cout << std::fixed << std::setprecision(5);
-	std::cout << "Time to process a range of " << input.size() 
-			  << " elements with std::vector : " << vectorTime << " us" << std::endl;
-	std::cout << "Time to process a range of " << input.size() 
-			  << " elements with std::deque  : " << dequeTime << " us" << std::endl;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	printSequence(out, "After: ", vectorData, options.show);
+	out.flush();
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printTime += getTimeDifference(start, end);
+
+	// Output timing, comparison counts and sort memory; sorting and printing are timed apart
+	printTiming(out, input.size(), "std::vector : ", vectorTime, vectorStats, 0);
+	printTiming(out, input.size(), "std::deque  : ", dequeTime, dequeStats, 0);
+	printTiming(out, input.size(), "BlockList   : ", blockTime, blockStats, 0);
+	printTiming(out, input.size(), "radix+vector: ", radixTime, radixStats, radixBuckets);
+	out.append("Time to print the Before/After lines : ");
+	out.appendFixed(printTime, 5);
+	out.append(" us\n");
+	out.flush();
+	return true;
 }
@@ -5,13 +5,39 @@
 #include <deque>
 #include <string>
 #include <iostream>
-#include <iomanip>
 #include <cstdlib>
 #include <climits>
-#include <sys/time.h>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include "FordJohnson.hpp"
+#include "BlockList.hpp"
+#include "ParallelSort.hpp"
+#include "NumberReader.hpp"
+#include "OutputBuffer.hpp"
+#include "ExternalSort.hpp"
+#include "RadixPartition.hpp"
 
 class PmergeMe
 {
+public:
+	// Command-line options, given as leading "--name=value" arguments
+	struct Options
+	{
+		SortPolicy	policy;		// --policy=optimal (default) | --policy=fast
+		size_t		jobs;		// --jobs=N sorting threads, 1 (default) to maxJobs
+		std::string	input;		// --input=FILE reads the numbers from FILE ("-" is stdin)
+		bool		binary;		// --binary: that input is packed 32-bit little-endian ints
+		size_t		show;		// --show=all (default) | none | K: elements per Before/After line
+		size_t		memory;		// --memory=SIZE[K|M|G]: external sort of --input within SIZE bytes
+		std::string	tempDir;	// --temp-dir=DIR for its runs (default $TMPDIR, then /tmp)
+
+		Options();
+	};
+
+	static const size_t maxJobs = 256;
+	static const size_t showAll = static_cast<size_t>(-1);
+
 private:
 	// Orthodox Canonical Form - private constructors since this is a utility class
 	PmergeMe();
@@ -19,27 +45,21 @@ private:
 	PmergeMe& operator=(const PmergeMe& other);
 	~PmergeMe();
 
-	// Container-specific Ford-Johnson implementations
-	static void fordJohnsonVector(std::vector<int>& a);
-	static void fordJohnsonDeque(std::deque<int>& a);
-
-	// Container-specific pairing and sorting helpers
-	static void pairAndSortVector(const std::vector<int>& in, std::vector<int>& maxes, std::vector<int>& mins, int& straggler, bool& hasStraggler);
-	static void pairAndSortDeque(const std::deque<int>& in, std::deque<int>& maxes, std::deque<int>& mins, int& straggler, bool& hasStraggler);
-
-	// Container-specific binary insertion
-	static void binaryInsertVector(std::vector<int>& chain, int value);
-	static void binaryInsertDeque(std::deque<int>& chain, int value);
-
 	// Shared helper functions
-	static std::vector<size_t> jacobsthalIndices(size_t mCount);
 	static bool parsePositiveInt(const std::string& s, int& out);
-	static double getTimeDifference(const struct timeval& start, const struct timeval& end);
+	static bool parseOption(const std::string& arg, Options& options);
+	static double getTimeDifference(const struct timespec& start, const struct timespec& end);
+	static bool parseMemory(const std::string& s, size_t& out);
+	static void printSequence(OutputBuffer& out, const char* label, const std::vector<int>& values, size_t show);
+	static void printTiming(OutputBuffer& out, size_t size, const char* label, double micros,
+		const SortStats& stats, size_t buckets);
+	static bool runExternal(const Options& options);
 
 public:
 	// Main public interface
-	static bool parseArgs(int argc, char** argv, std::vector<int>& out);
-	static void run(const std::vector<int>& input);
+	static bool parseArgs(int argc, char** argv, std::vector<int>& out, Options& options);
+	// Returns false if an external sort hit invalid input or an I/O error
+	static bool run(const std::vector<int>& input, const Options& options);
 };
 
 #endif
@@ -0,0 +1,178 @@
+#include "RadixPartition.hpp"
+#include <functional>
+
+// Orthodox Canonical Form - private constructors
+RadixPartition::RadixPartition() {}
+RadixPartition::RadixPartition(const RadixPartition& other) { (void)other; }
+RadixPartition& RadixPartition::operator=(const RadixPartition& other) { (void)other; return *this; }
+RadixPartition::~RadixPartition() {}
+
+RadixPartition::HistogramTask::HistogramTask(const int* v, size_t b, size_t e, int m, unsigned s, size_t* c)
+	: values(v), begin(b), end(e), minimum(m), shift(s), counts(c) {}
+
+void RadixPartition::HistogramTask::run()
+{
+	for (size_t i = begin; i < end; i++)
+		counts[static_cast<unsigned>(values[i] - minimum) >> shift]++;
+}
+
+RadixPartition::ScatterTask::ScatterTask(const int* v, size_t b, size_t e, int m, unsigned s, size_t* o, int* d)
+	: values(v), begin(b), end(e), minimum(m), shift(s), offsets(o), out(d) {}
+
+void RadixPartition::ScatterTask::run()
+{
+	for (size_t i = begin; i < end; i++)
+		out[offsets[static_cast<unsigned>(values[i] - minimum) >> shift]++] = values[i];
+}
+
+RadixPartition::BucketSortTask::BucketSortTask(const int* s, int* v, const size_t* b, size_t f, size_t l,
+	SortPolicy p)
+	: scattered(s), values(v), bounds(b), first(f), last(l), policy(p) {}
+
+// One order buffer, sized for the largest bucket, serves every bucket; the
+// engine's own buffers live for one bucket only, so the largest set counts
+void RadixPartition::BucketSortTask::run()
+{
+	size_t largest = 0;
+	for (size_t b = first; b < last; b++)
+	{
+		if (bounds[b + 1] - bounds[b] > largest)
+			largest = bounds[b + 1] - bounds[b];
+	}
+
+	std::vector<size_t> order;
+	order.reserve(largest);
+	recordBuffer(stats, order);
+	size_t workspace = 0;
+
+	for (size_t b = first; b < last; b++)
+	{
+		size_t begin = bounds[b];
+		size_t size = bounds[b + 1] - begin;
+		if (size == 1)
+			values[begin] = scattered[begin];
+		if (size <= 1)
+			continue;
+
+		SortStats bucket;
+		size_t orderBytes = order.capacity() * sizeof(size_t);
+		sortKeys(scattered + begin, size, std::less<int>(), policy, bucket, order);
+		for (size_t i = 0; i < size; i++)
+			values[begin + i] = scattered[begin + order[i]];
+
+		stats.comparisons += bucket.comparisons;
+		stats.speculative += bucket.speculative;
+		stats.boundaryHits += bucket.boundaryHits;
+		stats.rounds += bucket.rounds;
+		stats.allocations += bucket.allocations - 1;	// order is already booked
+		if (bucket.peakBytes - orderBytes > workspace)
+			workspace = bucket.peakBytes - orderBytes;
+		if (bucket.largestRound > stats.largestRound)
+			stats.largestRound = bucket.largestRound;
+	}
+	stats.peakBytes += workspace;
+}
+
+// Bits needed to write value (0 for 0)
+unsigned RadixPartition::bitWidth(unsigned long value)
+{
+	unsigned bits = 0;
+	while (value)
+	{
+		bits++;
+		value >>= 1;
+	}
+	return bits;
+}
+
+SortStats RadixPartition::sort(std::vector<int>& values, SortPolicy policy, size_t jobs, size_t& buckets)
+{
+	SortStats stats;
+	size_t n = values.size();
+	buckets = 1;
+	if (n <= 1)
+		return stats;
+
+	int minimum = values[0];
+	int maximum = values[0];
+	for (size_t i = 1; i < n; i++)
+	{
+		if (values[i] < minimum)
+			minimum = values[i];
+		if (values[i] > maximum)
+			maximum = values[i];
+	}
+
+	// Enough bits for targetBucket-sized buckets, but never more than the
+	// key range has: a partition on constant bits puts everything in one
+	unsigned span = bitWidth(static_cast<unsigned long>(maximum - minimum));
+	unsigned bits = bitWidth((n - 1) / targetBucket);
+	if (bits > maxRadixBits)
+		bits = maxRadixBits;
+	if (bits > span)
+		bits = span;
+	if (bits == 0)
+		return mergeInsertionSortParallel(values, std::less<int>(), policy, jobs);
+
+	unsigned shift = span - bits;
+	buckets = static_cast<size_t>(1) << bits;
+	if (jobs > n / parallelMinChunk)
+		jobs = n / parallelMinChunk;
+	if (jobs < 1)
+		jobs = 1;
+
+	// Pass 1: each slice counts its own buckets
+	std::vector<size_t> counts(jobs * buckets, 0);
+	recordBuffer(stats, counts);
+	std::vector<HistogramTask> histograms;
+	for (size_t j = 0; j < jobs; j++)
+		histograms.push_back(HistogramTask(&values[0], n * j / jobs, n * (j + 1) / jobs, minimum, shift,
+			&counts[j * buckets]));
+	runConcurrently(histograms);
+
+	// Bucket-major prefix sums turn the counts into each slice's first
+	// slot in every bucket, so slices land in input order (stable)
+	std::vector<size_t> bounds(buckets + 1);
+	recordBuffer(stats, bounds);
+	size_t next = 0;
+	for (size_t b = 0; b < buckets; b++)
+	{
+		bounds[b] = next;
+		for (size_t j = 0; j < jobs; j++)
+		{
+			size_t count = counts[j * buckets + b];
+			counts[j * buckets + b] = next;
+			next += count;
+		}
+	}
+	bounds[buckets] = n;
+
+	// Pass 2: scatter every slice into its slots
+	std::vector<int> scattered(n);
+	recordBuffer(stats, scattered);
+	std::vector<ScatterTask> scatters;
+	for (size_t j = 0; j < jobs; j++)
+		scatters.push_back(ScatterTask(&values[0], n * j / jobs, n * (j + 1) / jobs, minimum, shift,
+			&counts[j * buckets], &scattered[0]));
+	runConcurrently(scatters);
+
+	// Pass 3: runs of whole buckets, about n / jobs elements each, sorted
+	// on their own threads straight back into values
+	std::vector<BucketSortTask> sorts;
+	size_t first = 0;
+	for (size_t j = 0; j < jobs && first < buckets; j++)
+	{
+		size_t goal = n * (j + 1) / jobs;
+		size_t last = first + 1;
+		while (last < buckets && bounds[last + 1] <= goal)
+			last++;
+		if (j + 1 == jobs)
+			last = buckets;
+		sorts.push_back(BucketSortTask(&scattered[0], &values[0], &bounds[0], first, last, policy));
+		first = last;
+	}
+	runConcurrently(sorts);
+	for (size_t j = 0; j < sorts.size(); j++)
+		addStats(stats, sorts[j].stats);
+	return stats;
+}
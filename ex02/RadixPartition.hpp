@@ -0,0 +1,84 @@
+#ifndef RADIXPARTITION_HPP
+# define RADIXPARTITION_HPP
+
+#include <vector>
+#include <cstddef>
+#include "ParallelSort.hpp"
+
+// Radix-partitioned pre-pass for the positive ints PmergeMe sorts.
+// The high bits of (value - min) split the input into cache-sized
+// buckets: one counting pass and one stable scatter, both cut into
+// `jobs` slices on their own threads. Every bucket then holds a
+// contiguous key range, so sorting each one with the merge-insertion
+// engine and laying them end to end sorts the whole input. Buckets are
+// handed out to threads in runs of about n / jobs elements.
+// Skewed inputs can leave one bucket much larger than the rest; it is
+// still sorted correctly, just with less to gain from the partition.
+class RadixPartition
+{
+public:
+	// Elements per bucket aimed for: the bucket and the engine's
+	// workspace for it (about 15 words per element) fit a 256 KiB L2
+	static const size_t targetBucket = 2048;
+
+	// At most 2^12 buckets: more scatter streams than that thrash the TLB
+	static const size_t maxRadixBits = 12;
+
+	// Sorts values in place; buckets receives the number of buckets used
+	static SortStats sort(std::vector<int>& values, SortPolicy policy, size_t jobs, size_t& buckets);
+
+private:
+	// Orthodox Canonical Form - private constructors since this is a utility class
+	RadixPartition();
+	RadixPartition(const RadixPartition& other);
+	RadixPartition& operator=(const RadixPartition& other);
+	~RadixPartition();
+
+	// Counts the bucket of every value in [begin, end)
+	struct HistogramTask
+	{
+		const int*	values;
+		size_t		begin;
+		size_t		end;
+		int			minimum;
+		unsigned	shift;
+		size_t*		counts;
+
+		HistogramTask(const int* v, size_t b, size_t e, int m, unsigned s, size_t* c);
+		void run();
+	};
+
+	// Moves every value in [begin, end) to its bucket, in input order
+	struct ScatterTask
+	{
+		const int*	values;
+		size_t		begin;
+		size_t		end;
+		int			minimum;
+		unsigned	shift;
+		size_t*		offsets;	// next free slot of each bucket for this slice
+		int*		out;
+
+		ScatterTask(const int* v, size_t b, size_t e, int m, unsigned s, size_t* o, int* d);
+		void run();
+	};
+
+	// Sorts buckets [first, last) of the scattered values back into place
+	struct BucketSortTask
+	{
+		const int*		scattered;
+		int*			values;
+		const size_t*	bounds;		// bucket b is [bounds[b], bounds[b + 1])
+		size_t			first;
+		size_t			last;
+		SortPolicy		policy;
+		SortStats		stats;
+
+		BucketSortTask(const int* s, int* v, const size_t* b, size_t f, size_t l, SortPolicy p);
+		void run();
+	};
+
+	static unsigned bitWidth(unsigned long value);
+};
+
+#endif
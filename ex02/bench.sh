@@ -0,0 +1,95 @@
+#!/bin/bash
+
+# PmergeMe performance regression suite (run by "make bench")
+# Workload: ten million random positive ints, read with --input. Every
+# in-memory strategy is recorded from PmergeMe's own timing lines, with
+# the wall-clock fast policy (merge-insertion proper needs about 15
+# words per element, over a gigabyte at this size); the external sort
+# and the whole run are timed from outside. Thread scaling is measured
+# by PmergeMe_bench: the fast vector sort of a million values at each
+# BENCH_JOBS thread count, one stage per count.
+# One run per stage unless BENCH_REPS says otherwise: each takes a while.
+
+BENCH_REPS=${BENCH_REPS:-1}
+source ../common/bench.sh
+
+COUNT=${BENCH_COUNT:-10000000}
+SCALE_COUNT=${BENCH_SCALE_COUNT:-1000000}
+JOBS=${BENCH_JOBS:-1,2,4,8}
+INPUT="$BENCH_DIR/random_$COUNT.txt"
+
+if [ ! -x "./PmergeMe" ] || [ ! -x "./PmergeMe_bench" ]; then
+    echo -e "${RED}Error: PmergeMe or PmergeMe_bench not found. Please run 'make PmergeMe PmergeMe_bench' first.${NC}"
+    exit 1
+fi
+
+bench_init "$(pwd)/bench_baseline.txt" "PmergeMe Performance Regression Suite"
+
+# Values straight from the generator: 1 .. 2147483646
+if [ ! -f "$INPUT" ]; then
+    awk -v n="$COUNT" "$BENCH_AWK_LCG"'
+    BEGIN {
+        lcg_state = 19650218
+        for (i = 0; i < n; i++)
+            print lcg_next()
+    }' > "$INPUT"
+fi
+
+# Function to check that the first values of an After line are ascending
+check_after() {
+    local output="$1"
+    local label="$2"
+
+    if ! echo "$output" | grep "^After: " | sed 's/^After: //; s/ \[\.\.\.\]$//' | tr ' ' '\n' | sort -nc 2>/dev/null; then
+        bench_error "$label: After line is not sorted"
+    fi
+}
+
+check_after "$(./PmergeMe --input="$INPUT" --memory=64M --policy=fast --show=1000 2>&1)" "external sort"
+
+# In-memory strategies: fastest of BENCH_REPS runs, stage by stage
+timings=""
+best_ns=""
+for ((rep = 0; rep < BENCH_REPS; rep++)); do
+    start=$(bench_now)
+    if ! output=$(./PmergeMe --input="$INPUT" --policy=fast --show=1000 2>&1); then
+        bench_error "PmergeMe failed on $INPUT"
+        break
+    fi
+    end=$(bench_now)
+    if [ -z "$best_ns" ] || [ $((end - start)) -lt "$best_ns" ]; then
+        best_ns=$((end - start))
+    fi
+    check_after "$output" "in-memory sort"
+    timings="$timings$(echo "$output" | sed -n 's/^Time to process a range of [0-9]* elements with \(.*\): *\([0-9.]*\) us.*/\1 \2/p')"$'\n'
+done
+
+if [ -n "$best_ns" ]; then
+    best=$(echo "$timings" | awk 'NF == 2 && (!($1 in best) || $2 < best[$1]) { best[$1] = $2 }
+        END { for (k in best) print k, best[k] }')
+    for stage in "std::vector pmergeme_vector" "std::deque pmergeme_deque" \
+        "BlockList pmergeme_blocklist" "radix+vector pmergeme_radix_vector"; do
+        set -- $stage
+        micros=$(echo "$best" | awk -v label="$1" '$1 == label { print $2 }')
+        if [ -z "$micros" ]; then
+            bench_error "PmergeMe printed no $1 timing"
+            continue
+        fi
+        bench_record "$2" "$COUNT" "$(awk -v us="$micros" 'BEGIN { printf "%.6f", us / 1e6 }')"
+    done
+    bench_record "pmergeme_end_to_end" "$COUNT" "$(bench_seconds "$best_ns")"
+fi
+
+# Thread scaling: CSV rows "algorithm,distribution,size,jobs,...,min_us,..."
+if output=$(./PmergeMe_bench --sizes="$SCALE_COUNT" --distributions=random --algorithms=mi_fast_vector \
+    --jobs="$JOBS" --reps="$BENCH_REPS" --warmup=0); then
+    while IFS=, read -r algorithm distribution size jobs comparisons allocations peak minimum rest; do
+        bench_record "pmergeme_fast_jobs_$jobs" "$size" "$(awk -v us="$minimum" 'BEGIN { printf "%.6f", us / 1e6 }')"
+    done <<< "$(echo "$output" | tail -n +2)"
+else
+    bench_error "PmergeMe_bench failed the thread scaling run"
+fi
+
+bench_time "pmergeme_external_64M" "$COUNT" ./PmergeMe --input="$INPUT" --memory=64M --policy=fast --show=none
+
+bench_finish
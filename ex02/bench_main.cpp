@@ -0,0 +1,21 @@
+#include "Benchmark.hpp"
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+	Benchmark::Options options;
+
+	// Parse and validate arguments
+	if (!Benchmark::parseArgs(argc, argv, options))
+	{
+		std::cerr << "Error" << std::endl;
+		std::cerr << "Usage: " << argv[0] << " [--sizes=10,100,...] [--distributions=random,sorted,"
+				  << "reversed,few_unique,sawtooth] [--algorithms=mi_vector,mi_deque,mi_fast_vector,"
+				  << "mi_blocklist,rp_vector,std_sort,std_stable_sort,bi_vector,bi_deque,bi_blocklist] "
+				  << "[--jobs=1,2,...] [--reps=N] [--warmup=N] [--seed=N] [--format=csv|json]"
+				  << std::endl;
+		return 1;
+	}
+
+	return Benchmark::run(options) ? 0 : 1;
+}
@@ -3,16 +3,21 @@
 int main(int argc, char** argv)
 {
 	std::vector<int> input;
+	PmergeMe::Options options;
 
 	// Parse and validate arguments
-	if (!PmergeMe::parseArgs(argc, argv, input))
+	if (!PmergeMe::parseArgs(argc, argv, input, options))
+	{
+		std::cerr << "Error" << std::endl;
+		return 1;
+	}
+
+	// Run the sorting algorithm with every container (or the external sort)
+	if (!PmergeMe::run(input, options))
 	{
 		std::cerr << "Error" << std::endl;
 		return 1;
 	}
 
-	// Run the sorting algorithm with both containers
-	PmergeMe::run(input);
-	
 	return 0;
 }
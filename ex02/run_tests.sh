@@ -124,6 +124,12 @@ run_test() {
             if ! echo "$output" | grep -q "Time to process.*std::deque"; then
                 echo -e "${YELLOW}  ⚠ Warning: Missing deque timing line${NC}"
             fi
+            if ! echo "$output" | grep -q "Time to process.*BlockList"; then
+                echo -e "${YELLOW}  ⚠ Warning: Missing BlockList timing line${NC}"
+            fi
+            if ! echo "$output" | grep -q "Time to process.*radix+vector"; then
+                echo -e "${YELLOW}  ⚠ Warning: Missing radix+vector timing line${NC}"
+            fi
             
             # CRITICAL: Check if the result is actually sorted and contains same elements
             after_sequence=$(extract_after_sequence "$output")
@@ -282,6 +288,374 @@ test_performance() {
     TOTAL_TESTS=$((TOTAL_TESTS + 1))
 }
 
+# Function to benchmark large inputs (these go through InsertionChain)
+# Sizes stay below ARG_MAX; every run is checked against sort -n
+test_large_performance() {
+    echo -e "\n${BLUE}=== Large Input Benchmarks ===${NC}"
+
+    if ! command -v shuf >/dev/null 2>&1; then
+        echo -e "${YELLOW}Skipping large benchmarks: 'shuf' not available${NC}"
+        return
+    fi
+
+    for size in 70000 85000 100000; do
+        TOTAL_TESTS=$((TOTAL_TESTS + 1))
+        large_args=$(shuf -i 1-2147483647 -n $size | tr '\n' ' ')
+
+        echo -n "Benchmarking $size elements... "
+        output=$(./PmergeMe $large_args 2>&1)
+        exit_code=$?
+
+        if [ $exit_code -ne 0 ]; then
+            echo -e "${RED}✗ FAIL${NC} (exit code $exit_code)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+            continue
+        fi
+
+        expected=$(echo "$large_args" | tr ' ' '\n' | grep . | sort -n | tr '\n' ' ' | sed 's/ $//')
+        if [ "$(extract_after_sequence "$output")" != "$expected" ]; then
+            echo -e "${RED}✗ FAIL${NC} (result differs from sort -n)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+            continue
+        fi
+
+        echo -e "${GREEN}✓ PASS${NC}"
+        echo "$output" | grep "^Time to process" | sed 's/^/  /'
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    done
+}
+
+# Function to test bulk input from files and stdin (beyond ARG_MAX)
+test_file_input() {
+    echo -e "\n${BLUE}=== File Input Tests ===${NC}"
+
+    if ! command -v shuf >/dev/null 2>&1; then
+        echo -e "${YELLOW}Skipping file input tests: 'shuf' not available${NC}"
+        return
+    fi
+
+    local text_file=$(mktemp)
+    local binary_file=$(mktemp)
+    local expected_file=$(mktemp)
+    shuf -i 1-2147483647 -n 300000 > "$text_file"
+    sort -n "$text_file" | tr '\n' ' ' | sed 's/ $//' > "$expected_file"
+
+    # Same numbers as packed little-endian ints, built with printf escapes
+    while read -r n; do
+        printf '\\x%02x\\x%02x\\x%02x\\x%02x' $((n & 255)) $((n >> 8 & 255)) $((n >> 16 & 255)) $((n >> 24 & 255))
+    done < <(head -n 2000 "$text_file") | xargs -0 printf '%b' > "$binary_file"
+
+    local cases=(
+        "Text file of 300000 numbers|--policy=fast --input=$text_file|"
+        "Text from stdin|--policy=fast --input=-|$text_file"
+        "Binary file of 2000 numbers|--binary --input=$binary_file|"
+        "Threaded sort, 4 jobs|--policy=fast --jobs=4 --input=$text_file|"
+    )
+
+    for test_case in "${cases[@]}"; do
+        local description=$(echo "$test_case" | cut -d'|' -f1)
+        local args=$(echo "$test_case" | cut -d'|' -f2)
+        local stdin_file=$(echo "$test_case" | cut -d'|' -f3)
+        TOTAL_TESTS=$((TOTAL_TESTS + 1))
+
+        if [ -n "$stdin_file" ]; then
+            output=$(./PmergeMe $args < "$stdin_file" 2>&1)
+        else
+            output=$(./PmergeMe $args 2>&1)
+        fi
+        exit_code=$?
+
+        if [[ "$args" == *--binary* ]]; then
+            expected=$(head -n 2000 "$text_file" | sort -n | tr '\n' ' ' | sed 's/ $//')
+        else
+            expected=$(cat "$expected_file")
+        fi
+
+        if [ $exit_code -ne 0 ]; then
+            echo -e "${RED}✗ FAIL${NC} | $description (exit code $exit_code)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        elif [ "$(extract_after_sequence "$output")" != "$expected" ]; then
+            echo -e "${RED}✗ FAIL${NC} | $description (result differs from sort -n)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        else
+            echo -e "${GREEN}✓ PASS${NC} | $description"
+            PASSED_TESTS=$((PASSED_TESTS + 1))
+        fi
+    done
+
+    # Threaded merge-insertion proper: 30000 values give every one of the
+    # 3 chunks more than the 4096 elements below which jobs are ignored
+    local threaded_file=$(mktemp)
+    head -n 30000 "$text_file" > "$threaded_file"
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(./PmergeMe --jobs=3 --input="$threaded_file" 2>&1)
+    if [ $? -eq 0 ] && [ "$(extract_after_sequence "$output")" = "$(sort -n "$threaded_file" | tr '\n' ' ' | sed 's/ $//')" ]; then
+        echo -e "${GREEN}✓ PASS${NC} | Threaded merge-insertion, 3 jobs"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | Threaded merge-insertion, 3 jobs (result differs from sort -n)"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    # Many equal keys and more jobs than runs per round: every round, the
+    # last single merge included, is cut into segments at co-ranks
+    shuf -i 1-50 -n 40000 -r > "$threaded_file"
+    local sequential=$(./PmergeMe --policy=fast --input="$threaded_file" 2>&1 | grep "^After: ")
+    for jobs in 7 8; do
+        TOTAL_TESTS=$((TOTAL_TESTS + 1))
+        output=$(./PmergeMe --policy=fast --jobs=$jobs --input="$threaded_file" 2>&1)
+        if [ $? -eq 0 ] && [ "$(echo "$output" | grep "^After: ")" = "$sequential" ]; then
+            echo -e "${GREEN}✓ PASS${NC} | Segmented merges with duplicates, $jobs jobs"
+            PASSED_TESTS=$((PASSED_TESTS + 1))
+        else
+            echo -e "${RED}✗ FAIL${NC} | Segmented merges with duplicates, $jobs jobs (differs from 1 job)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        fi
+    done
+    rm -f "$threaded_file"
+
+    # Invalid contents must still be rejected
+    local invalid=("5 01 3" "7 0" "4 2147483648" "" "1 2 x")
+    for content in "${invalid[@]}"; do
+        TOTAL_TESTS=$((TOTAL_TESTS + 1))
+        output=$(printf '%s' "$content" | ./PmergeMe --input=- 2>&1)
+        if [ $? -eq 1 ] && [ "$output" = "Error" ]; then
+            echo -e "${GREEN}✓ PASS${NC} | Rejects stdin '$content'"
+            PASSED_TESTS=$((PASSED_TESTS + 1))
+        else
+            echo -e "${RED}✗ FAIL${NC} | Accepted invalid stdin '$content'"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        fi
+    done
+
+    rm -f "$text_file" "$binary_file" "$expected_file"
+}
+
+# Function to test truncated and suppressed Before/After output
+test_output_options() {
+    echo -e "\n${BLUE}=== Output Option Tests ===${NC}"
+
+    local cases=(
+        "Truncated output|--show=2 5 4 3|Before: 5 4 [...]\\nAfter: 3 4 [...]"
+        "Limit above size|--show=9 5 4 3|Before: 5 4 3\\nAfter: 3 4 5"
+        "Suppressed output|--show=none 5 4 3|"
+        "Large values|2147483647 1000000000 10 1|Before: 2147483647 1000000000 10 1\\nAfter: 1 10 1000000000 2147483647"
+    )
+
+    for test_case in "${cases[@]}"; do
+        local description=$(echo "$test_case" | cut -d'|' -f1)
+        local args=$(echo "$test_case" | cut -d'|' -f2)
+        local expected=$(printf '%b' "$(echo "$test_case" | cut -d'|' -f3-)")
+        TOTAL_TESTS=$((TOTAL_TESTS + 1))
+
+        output=$(./PmergeMe $args 2>&1)
+        exit_code=$?
+        lines=$(echo "$output" | grep -v "^Time to ")
+        timings=$(echo "$output" | grep -c "^Time to ")
+
+        if [ $exit_code -eq 0 ] && [ "$lines" = "$expected" ] && [ "$timings" -eq 5 ]; then
+            echo -e "${GREEN}✓ PASS${NC} | $description"
+            PASSED_TESTS=$((PASSED_TESTS + 1))
+        else
+            echo -e "${RED}✗ FAIL${NC} | $description"
+            echo -e "  Output: $output"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        fi
+    done
+}
+
+# Function to smoke-test the benchmark suite (built by "make benchmark")
+test_benchmark_suite() {
+    echo -e "\n${BLUE}=== Benchmark Suite ===${NC}"
+
+    if [ ! -f "./PmergeMe_bench" ]; then
+        echo -e "${YELLOW}Skipping benchmark suite: run 'make PmergeMe_bench' first${NC}"
+        return
+    fi
+
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(./PmergeMe_bench --sizes=10,100 --reps=3 --format=json 2>&1)
+    exit_code=$?
+    rows=$(echo "$output" | grep -c '"algorithm"')
+    if [ $exit_code -eq 0 ] && [ "$rows" -eq 70 ]; then
+        echo -e "${GREEN}✓ PASS${NC} | JSON report with 70 cells"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | JSON report (got $rows cells)"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(./PmergeMe_bench --sizes=1000 --distributions=sawtooth --algorithms=mi_deque,std_sort --reps=1 2>&1)
+    if [ $? -eq 0 ] && [ "$(echo "$output" | wc -l)" -eq 3 ] && echo "$output" | head -1 | grep -q "^algorithm,"; then
+        echo -e "${GREEN}✓ PASS${NC} | CSV report with header"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | CSV report"
+        echo -e "  Output: $output"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    # Large enough for many buckets; the suite fails on an unsorted result
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    if ./PmergeMe_bench --sizes=50000 --algorithms=rp_vector --reps=1 --warmup=0 >/dev/null 2>&1; then
+        echo -e "${GREEN}✓ PASS${NC} | Radix-partitioned sort on every distribution"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | Radix-partitioned sort left a range unsorted"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    # Every threaded algorithm once per --jobs entry, the rest once
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(./PmergeMe_bench --sizes=20000 --distributions=random --algorithms=mi_fast_vector,rp_vector,std_sort \
+        --jobs=1,4 --reps=1 --warmup=0 2>&1)
+    if [ $? -eq 0 ] && [ "$(echo "$output" | cut -d, -f1,4 | tail -n +2 | tr '\n' ' ')" = \
+        "mi_fast_vector,1 mi_fast_vector,4 rp_vector,1 rp_vector,4 std_sort,1 " ]; then
+        echo -e "${GREEN}✓ PASS${NC} | Thread scaling cells for --jobs=1,4"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | Thread scaling cells for --jobs=1,4"
+        echo -e "  Output: $output"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    if ./PmergeMe_bench --distributions=zigzag >/dev/null 2>&1; then
+        echo -e "${RED}✗ FAIL${NC} | Accepted unknown distribution"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    else
+        echo -e "${GREEN}✓ PASS${NC} | Rejects unknown distribution"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    fi
+}
+
+# Function to test the external-memory sort against sort -n
+test_external_sort() {
+    echo -e "\n${BLUE}=== External Sort Tests ===${NC}"
+
+    if ! command -v shuf >/dev/null 2>&1; then
+        echo -e "${YELLOW}Skipping external sort tests: 'shuf' not available${NC}"
+        return
+    fi
+
+    local text_file=$(mktemp)
+    local temp_dir=$(mktemp -d)
+    shuf -i 1-2147483647 -n 200000 > "$text_file"
+    printf '5\n5\n5\n1\n1\n3\n' >> "$text_file"
+    local expected=$(sort -n "$text_file" | tr '\n' ' ' | sed 's/ $//')
+
+    # 256K forces dozens of runs
+    local cases=(
+        "Many runs|--memory=256K --policy=fast --temp-dir=$temp_dir"
+        "Merge-insertion runs|--memory=2M --temp-dir=$temp_dir"
+        "Whole input in one run|--memory=64M --policy=fast"
+        "Parallel runs|--memory=1M --policy=fast --jobs=2 --temp-dir=$temp_dir"
+    )
+
+    for test_case in "${cases[@]}"; do
+        local description=$(echo "$test_case" | cut -d'|' -f1)
+        local args=$(echo "$test_case" | cut -d'|' -f2)
+        TOTAL_TESTS=$((TOTAL_TESTS + 1))
+
+        output=$(./PmergeMe $args --input="$text_file" 2>&1)
+        exit_code=$?
+
+        if [ $exit_code -ne 0 ]; then
+            echo -e "${RED}✗ FAIL${NC} | $description (exit code $exit_code)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        elif [ "$(extract_after_sequence "$output")" != "$expected" ]; then
+            echo -e "${RED}✗ FAIL${NC} | $description (result differs from sort -n)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        elif [ -n "$(ls -A "$temp_dir")" ]; then
+            echo -e "${RED}✗ FAIL${NC} | $description (temporary files left behind)"
+            FAILED_TESTS=$((FAILED_TESTS + 1))
+        else
+            echo -e "${GREEN}✓ PASS${NC} | $description"
+            echo "$output" | grep "^Time to process" | sed 's/^/  /'
+            PASSED_TESTS=$((PASSED_TESTS + 1))
+        fi
+    done
+
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    if ./PmergeMe --memory=1M --temp-dir=/nonexistent/dir --input="$text_file" >/dev/null 2>&1; then
+        echo -e "${RED}✗ FAIL${NC} | Accepted a missing temporary directory"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    else
+        echo -e "${GREEN}✓ PASS${NC} | Rejects a missing temporary directory"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    fi
+
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(printf '4 2 01' | ./PmergeMe --memory=1M --input=- 2>&1)
+    if [ $? -eq 1 ] && [ "$output" = "Error" ]; then
+        echo -e "${GREEN}✓ PASS${NC} | Rejects invalid input while streaming"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | Accepted invalid input while streaming"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    # Invalid data after the first run: no partial Before line on stdout
+    local bad_file=$(mktemp)
+    (seq 1 3000; echo x) > "$bad_file"
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    stdout=$(./PmergeMe --memory=256K --show=3 --input="$bad_file" 2>/dev/null)
+    exit_code=$?
+    stderr=$(./PmergeMe --memory=256K --show=3 --input="$bad_file" 2>&1 >/dev/null)
+    if [ $exit_code -eq 1 ] && [ -z "$stdout" ] && [ "$stderr" = "Error" ]; then
+        echo -e "${GREEN}✓ PASS${NC} | Rejects invalid input after the first run, printing only Error"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | Invalid input after the first run (stdout: '$stdout')"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+    rm -f "$bad_file"
+
+    # The report gives the longest run actually written, not the capacity
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(./PmergeMe --memory=64M --policy=fast --show=none --input="$text_file" 2>&1)
+    if echo "$output" | grep -q " 1 runs of up to $(wc -l < "$text_file" | tr -d ' '), "; then
+        echo -e "${GREEN}✓ PASS${NC} | Reports the length of the only run"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | Run length report"
+        echo -e "  Output: $output"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    # Runs share one spill file, so their number isn't bounded by the
+    # descriptor limit: 124 runs under a limit of 64 descriptors
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(ulimit -n 64; seq 200000 -1 1 | ./PmergeMe --memory=256K --show=all --temp-dir="$temp_dir" \
+        --input=- 2>&1)
+    exit_code=$?
+    if [ $exit_code -eq 0 ] && echo "$output" | grep -q " 124 runs of up to " \
+        && [ "$(extract_after_sequence "$output")" = "$(seq 1 200000 | tr '\n' ' ' | sed 's/ $//')" ]; then
+        echo -e "${GREEN}✓ PASS${NC} | More runs than open descriptors allowed"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | More runs than open descriptors allowed (exit code $exit_code)"
+        echo "$output" | grep -v "^Before\|^After" | sed 's/^/  /'
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    # Small budgets keep a wide merge instead of many binary passes: the
+    # 124 runs take one intermediate pass, at the narrowest fan-in that can
+    TOTAL_TESTS=$((TOTAL_TESTS + 1))
+    output=$(seq 200000 -1 1 | ./PmergeMe --memory=256K --show=none --temp-dir="$temp_dir" --input=- 2>&1)
+    if echo "$output" | grep -q " 12-way merge in 2 passes"; then
+        echo -e "${GREEN}✓ PASS${NC} | 256K budget merges in 2 passes"
+        PASSED_TESTS=$((PASSED_TESTS + 1))
+    else
+        echo -e "${RED}✗ FAIL${NC} | 256K budget merges in 2 passes"
+        echo -e "  Output: $output"
+        FAILED_TESTS=$((FAILED_TESTS + 1))
+    fi
+
+    rm -rf "$text_file" "$temp_dir"
+}
+
 # Read and execute test cases from file
 echo -e "${BLUE}=== Basic Test Cases ===${NC}"
 while IFS='|' read -r expected_exit description args; do
@@ -297,6 +671,11 @@ done < test_cases.txt
 test_sorting_correctness
 test_random_sequences
 test_performance
+test_large_performance
+test_file_input
+test_output_options
+test_external_sort
+test_benchmark_suite
 
 # Print summary
 echo -e "\n${BLUE}=== Test Summary ===${NC}"